@@ -0,0 +1,100 @@
+// Helpers shared by the benchmarks.
+//
+// Every benchmark links this header once. It replaces the global
+// operator new/delete to count C++ heap allocations, so that each case can
+// report allocations per iteration next to its time. Each thread counts in
+// its own slot, so counting doesn't serialize threaded cases.
+#ifndef __MRUBYBIND_BENCH_H__
+#define __MRUBYBIND_BENCH_H__
+
+#include <mruby.h>
+#include <mruby/compile.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+namespace bench {
+
+// Allocation count of one thread. Written only by that thread, and never
+// freed, so that the counts of finished threads still add up.
+struct Counter {
+  std::atomic<size_t> n;
+  Counter* next;
+};
+
+static std::atomic<Counter*> counters(NULL);
+static thread_local Counter* counter = NULL;
+
+inline void count_allocation() {
+  if (!counter) {
+    // malloc, not new, which would count itself.
+    counter = static_cast<Counter*>(malloc(sizeof(Counter)));
+    if (!counter) {
+      throw std::bad_alloc();
+    }
+    counter->n.store(0, std::memory_order_relaxed);
+    counter->next = counters.load(std::memory_order_relaxed);
+    while (!counters.compare_exchange_weak(counter->next, counter)) {
+    }
+  }
+  counter->n.store(counter->n.load(std::memory_order_relaxed) + 1,
+                   std::memory_order_relaxed);
+}
+
+// Allocations on all threads so far.
+inline size_t allocations() {
+  size_t total = 0;
+  for (Counter* c = counters.load(); c; c = c->next) {
+    total += c->n.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+class Timer {
+public:
+  Timer(const char* name, long iterations)
+      : name_(name), iterations_(iterations), allocations_(allocations()),
+        start_(std::chrono::steady_clock::now()) {}
+  ~Timer() {
+    std::chrono::duration<double, std::nano> d =
+        std::chrono::steady_clock::now() - start_;
+    printf("%-32s %10.2f ns/iter %8.3f allocs/iter\n", name_,
+           d.count() / iterations_,
+           (double)(allocations() - allocations_) / iterations_);
+  }
+
+private:
+  const char* name_;
+  long iterations_;
+  size_t allocations_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+// Runs `code` and exits on an uncaught mruby exception.
+inline void run(mrb_state* mrb, const std::string& code) {
+  mrb_load_string(mrb, code.c_str());
+  if (mrb->exc) {
+    mrb_p(mrb, mrb_obj_value(mrb->exc));
+    exit(EXIT_FAILURE);
+  }
+}
+
+}  // namespace bench
+
+void* operator new(size_t size) {
+  bench::count_allocation();
+  if (void* p = malloc(size ? size : 1)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+  free(p);
+}
+
+#endif
@@ -0,0 +1,39 @@
+// Cost of passing a block to a bound function that calls it once.
+#include "bench.h"
+#include "mrubybind.h"
+
+#include <sstream>
+
+static const long N = 1000000;
+
+int yield_ref(mrubybind::FuncRef<int(int)> f) { return f(1); }
+
+int yield_ptr(mrubybind::FuncPtr<int(int)> f) { return f.func()(1); }
+
+void measure(mrb_state* mrb, const char* name, const char* call) {
+  std::stringstream s;
+  s << "i = 0\n"
+    << "while i < " << N << "\n"
+    << "  " << call << "\n"
+    << "  i += 1\n"
+    << "end\n";
+  bench::Timer t(name, N);
+  bench::run(mrb, s.str());
+}
+
+int main() {
+  mrb_state* mrb = mrb_open();
+
+  {
+    mrubybind::MrubyBind b(mrb);
+    b.bind("yield_ref", yield_ref);
+    b.bind("yield_ptr", yield_ptr);
+  }
+
+  measure(mrb, "loop only", "");
+  measure(mrb, "FuncRef block", "yield_ref { |a| a }");
+  measure(mrb, "FuncPtr block", "yield_ptr { |a| a }");
+
+  mrb_close(mrb);
+  return EXIT_SUCCESS;
+}
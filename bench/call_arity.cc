@@ -0,0 +1,52 @@
+// Cost of a call from mruby into a bound C++ function, per arity.
+#include "bench.h"
+#include "mrubybind.h"
+
+#include <sstream>
+
+static const long N = 1000000;
+
+int f0() { return 0; }
+int f1(int a) { return a; }
+int f2(int a, int b) { return a + b; }
+int f3(int a, int b, int c) { return a + b + c; }
+int f4(int a, int b, int c, int d) { return a + b + c + d; }
+int f8(int a, int b, int c, int d, int e, int f, int g, int h) {
+  return a + b + c + d + e + f + g + h;
+}
+
+void measure(mrb_state* mrb, const char* name, const char* call) {
+  std::stringstream s;
+  s << "i = 0\n"
+    << "while i < " << N << "\n"
+    << "  " << call << "\n"
+    << "  i += 1\n"
+    << "end\n";
+  bench::Timer t(name, N);
+  bench::run(mrb, s.str());
+}
+
+int main() {
+  mrb_state* mrb = mrb_open();
+
+  {
+    mrubybind::MrubyBind b(mrb);
+    b.bind("f0", f0);
+    b.bind("f1", f1);
+    b.bind("f2", f2);
+    b.bind("f3", f3);
+    b.bind("f4", f4);
+    b.bind("f8", f8);
+  }
+
+  measure(mrb, "loop only", "");
+  measure(mrb, "f0()", "f0");
+  measure(mrb, "f1(a)", "f1 1");
+  measure(mrb, "f2(a, b)", "f2 1, 2");
+  measure(mrb, "f3(a, b, c)", "f3 1, 2, 3");
+  measure(mrb, "f4(a, b, c, d)", "f4 1, 2, 3, 4");
+  measure(mrb, "f8(a, ..., h)", "f8 1, 2, 3, 4, 5, 6, 7, 8");
+
+  mrb_close(mrb);
+  return EXIT_SUCCESS;
+}
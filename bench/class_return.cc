@@ -0,0 +1,73 @@
+// Cost of returning a bound class value from C++ to mruby.
+#include "bench.h"
+#include "mrubybind.h"
+
+#include <sstream>
+#include <vector>
+
+static const long N = 1000000;
+
+static long copies = 0;
+
+class Small {
+public:
+  int a;
+};
+
+// Value type whose copy is a deep copy.
+class Large {
+public:
+  std::vector<int> data;
+
+  Large() : data(64) {}
+  Large(const Large& l) : data(l.data) { copies++; }
+  Large(Large&& l) : data(std::move(l.data)) {}
+  Large& operator=(const Large& l) {
+    data = l.data;
+    copies++;
+    return *this;
+  }
+};
+
+std::shared_ptr<Small> new_shared() { return std::make_shared<Small>(); }
+
+static std::shared_ptr<Small> kept = std::make_shared<Small>();
+std::shared_ptr<Small> get_shared() { return kept; }
+
+Large new_large() { return Large(); }
+
+void measure(mrb_state* mrb, const char* name, const char* call) {
+  std::stringstream s;
+  s << "i = 0\n"
+    << "while i < " << N << "\n"
+    << "  " << call << "\n"
+    << "  i += 1\n"
+    << "end\n";
+  long c = copies;
+  {
+    bench::Timer t(name, N);
+    bench::run(mrb, s.str());
+  }
+  printf("%-32s %10.3f copies/iter\n", "", (double)(copies - c) / N);
+}
+
+int main() {
+  mrb_state* mrb = mrb_open();
+
+  {
+    mrubybind::MrubyBind b(mrb);
+    b.bind_class<std::shared_ptr<Small> >("Small");
+    b.bind_class<Large>("Large");
+    b.bind("new_shared", new_shared);
+    b.bind("get_shared", get_shared);
+    b.bind("new_large", new_large);
+  }
+
+  measure(mrb, "loop only", "");
+  measure(mrb, "new shared_ptr", "new_shared");
+  measure(mrb, "shared_ptr copy", "get_shared");
+  measure(mrb, "large value", "new_large");
+
+  mrb_close(mrb);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,39 @@
+// Cost of calling a Ruby-defined method from C++.
+#include "bench.h"
+#include "mrubybind.h"
+
+static const long N = 1000000;
+
+int main() {
+  mrb_state* mrb = mrb_open();
+
+  {
+    mrubybind::MrubyBind b(mrb);
+  }
+
+  bench::run(mrb,
+             "class Hook\n"
+             "  def on_record(a)\n"
+             "    a\n"
+             "  end\n"
+             "end\n");
+  mrubybind::MrubyRef hook = mrubybind::load_string(mrb, "Hook.new");
+
+  {
+    bench::Timer t("MrubyRef::call", N);
+    for (long i = 0; i < N; i++) {
+      hook.call("on_record", (int)i);
+    }
+  }
+  {
+    mrubybind::MrubyMethod on_record(hook, "on_record");
+    bench::Timer t("MrubyMethod::call", N);
+    for (long i = 0; i < N; i++) {
+      on_record.call((int)i);
+    }
+  }
+
+  hook = mrubybind::MrubyRef();
+  mrb_close(mrb);
+  return EXIT_SUCCESS;
+}
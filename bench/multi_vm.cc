@@ -0,0 +1,58 @@
+// Throughput of independent VMs, one per thread, calling bound functions.
+//
+// Each thread opens its own VM, binds into it, runs a call loop and closes
+// it. The wall time per call, counted over all threads, should fall in
+// proportion to the number of threads.
+#include "bench.h"
+#include "mrubybind.h"
+
+#include <sstream>
+#include <thread>
+#include <vector>
+
+static const long N = 200000;
+
+class Point {
+public:
+  int x;
+};
+
+int add(int a, int b) { return a + b; }
+std::shared_ptr<Point> new_point() { return std::make_shared<Point>(); }
+int point_x(std::shared_ptr<Point> p) { return p->x; }
+
+void worker() {
+  mrb_state* mrb = mrb_open();
+  {
+    mrubybind::MrubyBind b(mrb);
+    b.bind_class<std::shared_ptr<Point> >("Point");
+    b.bind("add", add);
+    b.bind("new_point", new_point);
+    b.bind("point_x", point_x);
+  }
+  std::stringstream s;
+  s << "i = 0\n"
+    << "while i < " << N << "\n"
+    << "  add(i, point_x(new_point))\n"
+    << "  i += 1\n"
+    << "end\n";
+  bench::run(mrb, s.str());
+  mrb_close(mrb);
+}
+
+int main() {
+  unsigned int cores = std::thread::hardware_concurrency();
+  for (unsigned int n = 1; n <= (cores ? cores : 1); n *= 2) {
+    std::vector<std::thread> threads;
+    char name[32];
+    snprintf(name, sizeof(name), "%u threads", n);
+    bench::Timer t(name, N * n);
+    for (unsigned int i = 0; i < n; i++) {
+      threads.push_back(std::thread(worker));
+    }
+    for (size_t i = 0; i < threads.size(); i++) {
+      threads[i].join();
+    }
+  }
+  return EXIT_SUCCESS;
+}
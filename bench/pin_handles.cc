@@ -0,0 +1,51 @@
+// Cost of pinning and unpinning mruby objects held from C++ by MrubyRef.
+#include "bench.h"
+#include "mrubybind.h"
+
+#include <vector>
+
+static const long N = 100000;
+
+int main() {
+  mrb_state* mrb = mrb_open();
+  {
+    mrubybind::MrubyBind b(mrb);
+  }
+
+  std::vector<mrb_value> objects;
+  mrb_value keep = mrb_ary_new(mrb);
+  for (long i = 0; i < N; i++) {
+    mrubybind::MrubyArenaStore store(mrb);
+    mrb_value o = mrb_obj_new(mrb, mrb->object_class, 0, NULL);
+    mrb_ary_push(mrb, keep, o);
+    objects.push_back(o);
+  }
+
+  std::vector<mrubybind::MrubyRef> refs;
+  refs.reserve(N * 2);
+  {
+    bench::Timer t("pin new object", N);
+    for (long i = 0; i < N; i++) {
+      refs.push_back(mrubybind::MrubyRef(mrb, objects[i]));
+    }
+  }
+  {
+    bench::Timer t("pin pinned object", N);
+    for (long i = 0; i < N; i++) {
+      refs.push_back(mrubybind::MrubyRef(mrb, objects[i]));
+    }
+  }
+  {
+    bench::Timer t("copy ref", N);
+    for (long i = 0; i < N; i++) {
+      mrubybind::MrubyRef r = refs[i];
+    }
+  }
+  {
+    bench::Timer t("unpin", N * 2);
+    refs.clear();
+  }
+
+  mrb_close(mrb);
+  return EXIT_SUCCESS;
+}
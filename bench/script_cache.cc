@@ -0,0 +1,48 @@
+// Cost of load_string for a script run again and for new scripts, and of
+// running a MrubyScript.
+#include "bench.h"
+#include "mrubybind.h"
+
+#include <sstream>
+
+static const long N = 100000;
+
+static const char* script =
+    "def f(a)\n"
+    "  a.map { |x| x * 2 }.inject(0) { |s, x| s + x }\n"
+    "end\n"
+    "f([1, 2, 3])\n";
+
+int main() {
+  mrb_state* mrb = mrb_open();
+
+  {
+    mrubybind::MrubyBind b(mrb);
+  }
+
+  {
+    bench::Timer t("same script", N);
+    for (long i = 0; i < N; i++) {
+      mrubybind::load_string(mrb, script);
+    }
+  }
+  {
+    bench::Timer t("new script", N);
+    for (long i = 0; i < N; i++) {
+      std::stringstream s;
+      s << script << "# " << i << "\n";
+      mrubybind::load_string(mrb, s.str());
+    }
+    mrubybind::clear_script_cache(mrb);
+  }
+  {
+    mrubybind::MrubyScript s(mrb, script, "script.rb");
+    bench::Timer t("MrubyScript::run", N);
+    for (long i = 0; i < N; i++) {
+      s.run();
+    }
+  }
+
+  mrb_close(mrb);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,46 @@
+// Cost of converting std::vector to and from Array.
+#include "bench.h"
+#include "mrubybind.h"
+
+#include <sstream>
+
+static const long N = 100;
+static const int SIZE = 100000;
+
+std::vector<int> ints() { return std::vector<int>(SIZE, 1); }
+std::vector<double> doubles() { return std::vector<double>(SIZE, 0.5); }
+std::vector<std::string> strings() { return std::vector<std::string>(SIZE, "a"); }
+int count(const std::vector<int>& v) { return (int)v.size(); }
+
+void measure(mrb_state* mrb, const char* name, const char* call) {
+  std::stringstream s;
+  s << "a = ints\n"
+    << "i = 0\n"
+    << "while i < " << N << "\n"
+    << "  " << call << "\n"
+    << "  i += 1\n"
+    << "end\n";
+  bench::Timer t(name, N * SIZE);
+  bench::run(mrb, s.str());
+}
+
+int main() {
+  mrb_state* mrb = mrb_open();
+
+  {
+    mrubybind::MrubyBind b(mrb);
+    b.bind("ints", ints);
+    b.bind("doubles", doubles);
+    b.bind("strings", strings);
+    b.bind("count", count);
+  }
+
+  // Times are per element.
+  measure(mrb, "return vector<int>", "ints");
+  measure(mrb, "return vector<double>", "doubles");
+  measure(mrb, "return vector<string>", "strings");
+  measure(mrb, "pass vector<int>", "count a");
+
+  mrb_close(mrb);
+  return EXIT_SUCCESS;
+}
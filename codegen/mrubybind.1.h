@@ -34,3 +34,7 @@
 
 #include <iostream>
 #include <vector>
+
+// Expands to the template arguments of MrubyBind::bind<Func, func>() and the
+// other compile-time binding methods for a function or method pointer `f`.
+#define MRUBYBIND_FUNC(f)  decltype(f), f
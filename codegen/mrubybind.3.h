@@ -42,11 +42,27 @@ public:
       mrb_define_class_method_raw(mrb_, mod_, func_name_s, proc);
   }
 
+  // Bind function given as template argument:
+  //   b.bind<MRUBYBIND_FUNC(&square)>("square");
+  // The call is resolved at compile time, so small functions can be inlined.
+  template <class Func, Func func>
+  void bind(const char* func_name) {
+    MrubyArenaStore store(mrb_);
+    if (mod_ == mrb_->kernel_module)
+      mrb_define_method(mrb_, mod_, func_name, InlineBinder<Func, func>::call,
+                        InlineBinder<Func, func>::aspec());
+    else
+      mrb_define_class_method(mrb_, mod_, func_name, InlineBinder<Func, func>::call,
+                              InlineBinder<Func, func>::aspec());
+  }
+
   // Bind class.
   template <class Func>
   void bind_class(const char* class_name, Func new_func_ptr) {
     MrubyArenaStore store(mrb_);
     struct RClass *tc = mrb_define_class(mrb_, class_name, mrb_->object_class);
+    typedef typename ClassBinder<Func>::Class C;
+    MrubyBindStatus::lookup(mrb_)->set_class(ClassId<C>::get(), class_name, tc);
     MRB_SET_INSTANCE_TT(tc, MRB_TT_DATA);
     BindInstanceMethod(class_name, "initialize",
                        mrb_cptr_value(mrb_, (void*)new_func_ptr),
@@ -66,9 +82,7 @@ public:
     }
     name += class_name;
 
-    Type<C>::class_name = name;
-    Type<C&>::class_name = name;
-    MrubyBindStatus::search(mrb_)->set_class_conversion(name, name, true);
+    MrubyBindStatus::lookup(mrb_)->set_class(ClassId<C>::get(), name, tc);
     MRB_SET_INSTANCE_TT(tc, MRB_TT_DATA);
     BindInstanceMethod(module_name, class_name, "initialize",
                        mrb_cptr_value(mrb_, NULL),
@@ -92,6 +106,19 @@ public:
                        method_pptr_v, ClassBinder<Method>::call);
   }
 
+  template <class Method, Method method>
+  void bind_instance_method(const char* module_name, const char* class_name, const char* method_name) {
+    MrubyArenaStore store(mrb_);
+    mrb_define_method(mrb_, GetClass(module_name, class_name), method_name,
+                      InlineClassBinder<Method, method>::call,
+                      InlineClassBinder<Method, method>::aspec());
+  }
+
+  template <class Method, Method method>
+  void bind_instance_method(const char* class_name, const char* method_name) {
+    bind_instance_method<Method, method>(NULL, class_name, method_name);
+  }
+
   // Bind static method.
   template <class Method>
   void bind_static_method(const char* module_name, const char* class_name, const char* method_name,
@@ -115,6 +142,19 @@ public:
                           method_ptr);
   }
 
+  template <class Method, Method method>
+  void bind_static_method(const char* module_name, const char* class_name, const char* method_name) {
+    MrubyArenaStore store(mrb_);
+    mrb_define_class_method(mrb_, GetClass(module_name, class_name), method_name,
+                            InlineBinder<Method, method>::call,
+                            InlineBinder<Method, method>::aspec());
+  }
+
+  template <class Method, Method method>
+  void bind_static_method(const char* class_name, const char* method_name) {
+    bind_static_method<Method, method>(NULL, class_name, method_name);
+  }
+
   // Bind custom method.
   template <class Func>
   void bind_custom_method(const char* module_name, const char* class_name, const char* method_name, Func func_ptr) {
@@ -139,11 +179,50 @@ public:
     bind_custom_method(NULL, class_name, method_name, func_ptr);
   }
 
-  //add convertable class pair
+  template <class Func, Func func>
+  void bind_custom_method(const char* module_name, const char* class_name, const char* method_name) {
+    MrubyArenaStore store(mrb_);
+    mrb_define_method(mrb_, GetClass(module_name, class_name), method_name,
+                      InlineCustomClassBinder<Func, func>::call,
+                      InlineCustomClassBinder<Func, func>::aspec());
+  }
+
+  template <class Func, Func func>
+  void bind_custom_method(const char* class_name, const char* method_name) {
+    bind_custom_method<Func, func>(NULL, class_name, method_name);
+  }
+
+#if __cplusplus >= 201703L
+  // C++17 shorthand of the above: b.bind<&square>("square");
+  template <auto func>
+  void bind(const char* func_name) {
+    bind<decltype(func), func>(func_name);
+  }
+
+  template <auto method>
+  void bind_instance_method(const char* class_name, const char* method_name) {
+    bind_instance_method<decltype(method), method>(class_name, method_name);
+  }
+
+  template <auto method>
+  void bind_static_method(const char* class_name, const char* method_name) {
+    bind_static_method<decltype(method), method>(class_name, method_name);
+  }
+
+  template <auto func>
+  void bind_custom_method(const char* class_name, const char* method_name) {
+    bind_custom_method<decltype(func), func>(class_name, method_name);
+  }
+#endif
+
+  //add convertable class pair (either may be bound with bind_class later)
   void add_convertable(const char* class_name_first, const char* class_name_second)
   {
-    MrubyBindStatus::search(mrb_)->set_class_conversion(class_name_first, class_name_second, true);
-    MrubyBindStatus::search(mrb_)->set_class_conversion(class_name_second, class_name_first, true);
+    MrubyBindStatus::Data* d = MrubyBindStatus::lookup(mrb_);
+    if(d){
+      d->set_class_conversion(class_name_first, class_name_second);
+      d->set_class_conversion(class_name_second, class_name_first);
+    }
   }
 
   mrb_state* get_mrb(){
@@ -185,6 +264,41 @@ private:
 
 MrubyRef load_string(mrb_state* mrb, std::string code);
 
+// load_string() keeps each script it compiles, keyed by a hash of its text,
+// and runs it again without parsing. loaded counts the misses read from the
+// cache directory instead of compiled. The cache is cleared when it holds
+// 1024 scripts. A MrubyScript, compiled once, also skips hashing the text.
+struct ScriptCacheStats{
+  size_t hits;
+  size_t misses;
+  size_t loaded;
+  size_t size;
+};
+
+ScriptCacheStats get_script_cache_stats(mrb_state* mrb);
+
+// Directory where load_string() also keeps compiled scripts, dumped by
+// mrb_dump_irep, for other VMs and later runs to read instead of
+// compiling. Each file also holds the text, which must match before the
+// file is used. The directory must exist; an empty name turns it off.
+void set_script_cache_dir(mrb_state* mrb, const std::string& dir);
+
+// Drops the scripts kept in memory by load_string().
+void clear_script_cache(mrb_state* mrb);
+
+// Runs the calls and releases posted to mrb from other threads, and returns
+// their number. load_string() and MrubyScript::run() also run them; call
+// this on the VM thread to run them sooner, e.g. from a bound function. A
+// block that raises doesn't unwind the caller: the exception is in the
+// call's future.
+size_t run_pending(mrb_state* mrb);
+
+// Makes the calling thread the VM thread of mrb. The VM thread is the one
+// which did the first MrubyBind; call this on a thread the VM is handed to,
+// before it runs the VM. Calls and releases from any other thread are
+// posted for run_pending().
+void set_vm_thread(mrb_state* mrb);
+
 }  // namespace mrubybind
 
 #endif
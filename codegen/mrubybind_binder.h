@@ -0,0 +1,289 @@
+//===========================================================================
+// Binder specializations.
+//
+// Every binder fetches its arguments with Args<P...>::get(), which also
+// checks their count and types, and then unpacks them into the bound C++
+// function with an index_sequence.
+
+// Whether the last parameter is a FuncPtr or FuncRef, which may be given
+// as a block.
+template<class... P>
+struct TakesBlock : std::false_type {};
+
+template<class T>
+struct TakesBlock<FuncPtr<T> > : std::true_type {};
+
+template<class T>
+struct TakesBlock<FuncRef<T> > : std::true_type {};
+
+template<class P0, class P1, class... P>
+struct TakesBlock<P0, P1, P...> : TakesBlock<P1, P...> {};
+
+// Name of the running method for error messages, stored in the proc env.
+inline mrb_value env_func_name(mrb_state* mrb) {
+  return mrb_cfunc_env_get(mrb, 1);
+}
+
+// Name of the running method for error messages, for procs without env.
+inline mrb_value called_func_name(mrb_state* mrb) {
+  return mrb_symbol_value(mrb->c->ci->mid);
+}
+
+// Number of arguments given to the running method, not counting the block.
+inline int call_argc(mrb_state* mrb) {
+  int argc = mrb->c->ci->argc;
+  if(argc < 0){
+    // Called with a splat: the arguments are packed into an array.
+    argc = RARRAY_LEN(mrb->c->stack[1]);
+  }
+  return argc;
+}
+
+// Argument list of a bound function.
+template<class... P>
+struct Args {
+  static const int NPARAM = sizeof...(P);
+  static const bool BLOCK = TakesBlock<P...>::value;
+  static const int NREQ = BLOCK ? NPARAM - 1 : NPARAM;
+
+  // Method signature to declare to mruby.
+  static mrb_aspec aspec() {
+    return BLOCK ? MRB_ARGS_REQ(NREQ) | MRB_ARGS_OPT(1) | MRB_ARGS_BLOCK()
+                 : MRB_ARGS_REQ(NPARAM);
+  }
+
+  // Fetches the arguments of the running method into args, which has
+  // NPARAM + 1 elements, without building an argument array. Raises
+  // ArgumentError unless their count matches, then raises TypeError at the
+  // first argument which can't be converted.
+  static void get(mrb_state* mrb, mrb_value* args,
+                  mrb_value (*func_name)(mrb_state*) = env_func_name) {
+    int argc = call_argc(mrb);
+    if(argc < NREQ || argc > NPARAM){
+      raisenarg(mrb, func_name(mrb), argc, NPARAM);
+    }
+    fetch(mrb, args, make_index_sequence<NREQ>());
+    if(BLOCK){
+      // The last FuncPtr or FuncRef is given either as an argument or as a block.
+      int block = mrb_nil_p(args[NPARAM]) ? 0 : 1;
+      if(argc + block != NPARAM){
+        raisenarg(mrb, func_name(mrb), argc + block, NPARAM);
+      }
+      if(block){
+        args[NPARAM - 1] = args[NPARAM];
+      }
+    }
+    check(mrb, args, make_index_sequence<NPARAM>());
+  }
+
+  // mrb_get_args() format: "o" for each required argument, then "|o&" if
+  // the last parameter takes a block or "|&" otherwise.
+  template<size_t... I>
+  static void fetch(mrb_state* mrb, mrb_value* args, index_sequence<I...>) {
+    static const char format[] = {
+      ((void)I, 'o')..., '|', BLOCK ? 'o' : '&', BLOCK ? '&' : '\0', '\0'};
+    if(BLOCK){
+      args[NPARAM - 1] = mrb_nil_value();
+    }
+    mrb_get_args(mrb, format, &args[I]..., &args[NREQ], &args[NPARAM]);
+  }
+
+  template<size_t... I>
+  static void check(mrb_state* mrb, mrb_value* args, index_sequence<I...>) {
+    int checked[] = {0, (Type<P>::check(mrb, args[I]) ? 0 :
+                         (raise(mrb, I, type_name<P>(), args[I]), 0))...};
+    (void)mrb; (void)args; (void)checked;
+  }
+};
+
+// Calls a bound function and converts its result into mrb_value.
+template<class R>
+struct Result {
+  template<class F, class... A>
+  static mrb_value call(mrb_state* mrb, F f, A&&... a) {
+    return Type<R>::ret(mrb, f(std::forward<A>(a)...));
+  }
+
+  template<class C, class M, class... A>
+  static mrb_value call_method(mrb_state* mrb, C* instance, M m, A&&... a) {
+    return Type<R>::ret(mrb, (instance->*m)(std::forward<A>(a)...));
+  }
+};
+
+template<>
+struct Result<void> {
+  template<class F, class... A>
+  static mrb_value call(mrb_state*, F f, A&&... a) {
+    f(std::forward<A>(a)...);
+    return mrb_nil_value();
+  }
+
+  template<class C, class M, class... A>
+  static mrb_value call_method(mrb_state*, C* instance, M m, A&&... a) {
+    (instance->*m)(std::forward<A>(a)...);
+    return mrb_nil_value();
+  }
+};
+
+// R f(P...);
+template<class R, class... P>
+struct Binder<R (*)(P...)> {
+  static const int NPARAM = sizeof...(P);
+  static mrb_value call(mrb_state* mrb, mrb_value /*self*/) {
+    mrb_value args[NPARAM + 1];
+    Args<P...>::get(mrb, args);
+    mrb_value cfunc = mrb_cfunc_env_get(mrb, 0);
+    R (*fp)(P...) = (R (*)(P...))mrb_cptr(cfunc);
+    return invoke(mrb, fp, args, make_index_sequence<NPARAM>());
+  }
+
+  template<size_t... I>
+  static mrb_value invoke(mrb_state* mrb, R (*fp)(P...), mrb_value* args, index_sequence<I...>) {
+    (void)args;
+    return Result<R>::call(mrb, fp, Type<P>::get(mrb, args[I])...);
+  }
+};
+
+// C* ctor(P...);
+template<class C, class... P>
+struct ClassBinder<C* (*)(P...)> {
+  typedef C Class;
+  static const int NPARAM = sizeof...(P);
+  static mrb_value ctor(mrb_state* mrb, mrb_value self) {
+    DATA_TYPE(self) = &ClassBinder<C>::type_info;
+    DATA_PTR(self) = NULL;
+    mrb_value args[NPARAM + 1];
+    Args<P...>::get(mrb, args);
+    mrb_value cfunc = mrb_cfunc_env_get(mrb, 0);
+    C* (*ctor)(P...) = (C* (*)(P...))mrb_cptr(cfunc);
+    if(ctor)
+    {
+      C* instance = construct(mrb, ctor, args, make_index_sequence<NPARAM>());
+      DATA_PTR(self) = instance;
+    }
+    return self;
+  }
+
+  template<size_t... I>
+  static C* construct(mrb_state* mrb, C* (*ctor)(P...), mrb_value* args, index_sequence<I...>) {
+    (void)mrb; (void)args;
+    return ctor(Type<P>::get(mrb, args[I])...);
+  }
+};
+
+// class C { R f(P...) };
+template<class C, class R, class... P>
+struct ClassBinder<R (C::*)(P...)> {
+  static const int NPARAM = sizeof...(P);
+  static mrb_value call(mrb_state* mrb, mrb_value self) {
+    mrb_value args[NPARAM + 1];
+    Args<P...>::get(mrb, args);
+    C* instance = static_cast<C*>(DATA_PTR(self));
+    mrb_value cmethod = mrb_cfunc_env_get(mrb, 0);
+    typedef R (C::*M)(P...);
+    M mp = *(M*)RSTRING_PTR(cmethod);
+    return invoke(mrb, instance, mp, args, make_index_sequence<NPARAM>());
+  }
+
+  template<size_t... I>
+  static mrb_value invoke(mrb_state* mrb, C* instance, R (C::*mp)(P...), mrb_value* args, index_sequence<I...>) {
+    (void)args;
+    return Result<R>::call_method(mrb, instance, mp, Type<P>::get(mrb, args[I])...);
+  }
+};
+
+// custom method: R f(P0 self, P...) or R f(P0& self, P...)
+template<class R, class P0, class... P>
+struct CustomClassBinder<R (*)(P0, P...)> {
+  typedef typename std::remove_reference<P0>::type Self;
+  static const int NPARAM = sizeof...(P);
+  static mrb_value call(mrb_state* mrb, mrb_value self) {
+    mrb_value args[NPARAM + 1];
+    Args<P...>::get(mrb, args);
+    Self* instance = static_cast<Self*>(DATA_PTR(self));
+    mrb_value cmethod = mrb_cfunc_env_get(mrb, 0);
+    typedef R (*M)(P0, P...);
+    M mp = *(M*)RSTRING_PTR(cmethod);
+    return invoke(mrb, mp, *instance, args, make_index_sequence<NPARAM>());
+  }
+
+  template<size_t... I>
+  static mrb_value invoke(mrb_state* mrb, R (*mp)(P0, P...), Self& instance, mrb_value* args, index_sequence<I...>) {
+    (void)args;
+    return Result<R>::call(mrb, mp, instance, Type<P>::get(mrb, args[I])...);
+  }
+};
+
+//===========================================================================
+// Inline binders.
+//
+// The bound function is a template argument instead of a pointer stored in
+// the proc env, so the compiler can call it directly and inline it. The
+// procs are plain cfuncs without env.
+
+// R f(P...);
+template<class F, F f>
+struct InlineBinder;
+
+template<class R, class... P, R (*f)(P...)>
+struct InlineBinder<R (*)(P...), f> {
+  static const int NPARAM = sizeof...(P);
+  static mrb_aspec aspec() { return Args<P...>::aspec(); }
+  static mrb_value call(mrb_state* mrb, mrb_value /*self*/) {
+    mrb_value args[NPARAM + 1];
+    Args<P...>::get(mrb, args, called_func_name);
+    return invoke(mrb, args, make_index_sequence<NPARAM>());
+  }
+
+  template<size_t... I>
+  static mrb_value invoke(mrb_state* mrb, mrb_value* args, index_sequence<I...>) {
+    (void)args;
+    return Result<R>::call(mrb, f, Type<P>::get(mrb, args[I])...);
+  }
+};
+
+// class C { R f(P...) };
+template<class M, M m>
+struct InlineClassBinder;
+
+template<class C, class R, class... P, R (C::*m)(P...)>
+struct InlineClassBinder<R (C::*)(P...), m> {
+  static const int NPARAM = sizeof...(P);
+  static mrb_aspec aspec() { return Args<P...>::aspec(); }
+  static mrb_value call(mrb_state* mrb, mrb_value self) {
+    mrb_value args[NPARAM + 1];
+    Args<P...>::get(mrb, args, called_func_name);
+    C* instance = static_cast<C*>(DATA_PTR(self));
+    return invoke(mrb, instance, args, make_index_sequence<NPARAM>());
+  }
+
+  template<size_t... I>
+  static mrb_value invoke(mrb_state* mrb, C* instance, mrb_value* args, index_sequence<I...>) {
+    (void)args;
+    return Result<R>::call_method(mrb, instance, m, Type<P>::get(mrb, args[I])...);
+  }
+};
+
+// custom method: R f(P0 self, P...) or R f(P0& self, P...)
+template<class F, F f>
+struct InlineCustomClassBinder;
+
+template<class R, class P0, class... P, R (*f)(P0, P...)>
+struct InlineCustomClassBinder<R (*)(P0, P...), f> {
+  typedef typename std::remove_reference<P0>::type Self;
+  static const int NPARAM = sizeof...(P);
+  static mrb_aspec aspec() { return Args<P...>::aspec(); }
+  static mrb_value call(mrb_state* mrb, mrb_value self) {
+    mrb_value args[NPARAM + 1];
+    Args<P...>::get(mrb, args, called_func_name);
+    Self* instance = static_cast<Self*>(DATA_PTR(self));
+    return invoke(mrb, *instance, args, make_index_sequence<NPARAM>());
+  }
+
+  template<size_t... I>
+  static mrb_value invoke(mrb_state* mrb, Self& instance, mrb_value* args, index_sequence<I...>) {
+    (void)args;
+    return Result<R>::call(mrb, f, instance, Type<P>::get(mrb, args[I])...);
+  }
+};
+
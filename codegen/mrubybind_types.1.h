@@ -8,7 +8,23 @@
 #include <string>
 #include <functional>
 #include <memory>
+#include <utility>
+#include <tuple>
+#include <type_traits>
+#include <limits>
+#include <cmath>
+#include <cstdint>
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
 #include <map>
+#include <algorithm>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <future>
+#include <unordered_map>
+#include <vector>
 #include <iostream>
 
 namespace mrubybind {
@@ -33,6 +49,32 @@ public:
 
 };
 
+// Compile-time index sequence used to unpack arguments
+// (std::index_sequence is C++14).
+template<size_t... I>
+struct index_sequence {};
+
+template<size_t N, size_t... I>
+struct make_index_sequence_impl : make_index_sequence_impl<N - 1, N - 1, I...> {};
+
+template<size_t... I>
+struct make_index_sequence_impl<0, I...> {
+  typedef index_sequence<I...> type;
+};
+
+template<size_t N>
+using make_index_sequence = typename make_index_sequence_impl<N>::type;
+
+size_t new_class_id();
+
+// Small integer id of a bound C++ class, the same in every VM.
+template<class T> struct ClassId {
+    static size_t get(){
+        static const size_t id = new_class_id();
+        return id;
+    }
+};
+
 class MrubyBindStatus{
 
 public:
@@ -58,25 +100,338 @@ public:
             this->id = id;
         }
     };
-    typedef std::map<RBasic*, ObjectInfo> ObjectIdTable;
+    // Pinned objects and their ObjectInfo. Open addressing with linear
+    // probing, so lookups touch one contiguous array and entries need no
+    // allocation of their own.
+    class ObjectIdTable
+    {
+        struct Entry
+        {
+            RBasic* key;
+            ObjectInfo info;
+        };
+        std::vector<Entry> entries;
+        size_t count;
+
+        size_t slot(RBasic* p) const
+        {
+            size_t h = (size_t)((uintptr_t)p >> 3);
+            h ^= h >> 16;
+            h *= (size_t)0x9e3779b1u;
+            h ^= h >> 15;
+            return h & (entries.size() - 1);
+        }
+
+        size_t lookup(RBasic* p) const
+        {
+            size_t i = slot(p);
+            while(entries[i].key && entries[i].key != p){
+                i = (i + 1) & (entries.size() - 1);
+            }
+            return i;
+        }
+
+        void rehash(size_t capacity)
+        {
+            std::vector<Entry> old(capacity);
+            old.swap(entries);
+            for(size_t i = 0 ; i < old.size() ; i++){
+                if(old[i].key){
+                    entries[lookup(old[i].key)] = old[i];
+                }
+            }
+        }
+
+    public:
+        ObjectIdTable()
+        {
+            this->count = 0;
+        }
+
+        size_t size() const
+        {
+            return count;
+        }
+
+        ObjectInfo* find(RBasic* p)
+        {
+            if(count == 0){
+                return NULL;
+            }
+            Entry& e = entries[lookup(p)];
+            return e.key ? &e.info : NULL;
+        }
+
+        // p must not be in the table yet.
+        void insert(RBasic* p, const ObjectInfo& info)
+        {
+            if((count + 1) * 2 > entries.size()){
+                rehash(entries.empty() ? 16 : entries.size() * 2);
+            }
+            Entry& e = entries[lookup(p)];
+            e.key = p;
+            e.info = info;
+            count++;
+        }
+
+        void erase(RBasic* p)
+        {
+            if(count == 0){
+                return;
+            }
+            size_t mask = entries.size() - 1;
+            size_t i = lookup(p);
+            if(!entries[i].key){
+                return;
+            }
+            // Shift the following entries of the probe run back so that
+            // lookups don't need tombstones.
+            for(size_t j = (i + 1) & mask ; entries[j].key ; j = (j + 1) & mask){
+                size_t k = slot(entries[j].key);
+                if(((j - k) & mask) >= ((j - i) & mask)){
+                    entries[i] = entries[j];
+                    i = j;
+                }
+            }
+            entries[i].key = NULL;
+            count--;
+        }
+    };
     typedef std::vector<size_t> FreeIdArray;
 
+    // Bound class of a C++ type in a VM, and the classes also accepted
+    // for it.
+    struct ClassEntry
+    {
+        RClass* klass;
+        std::vector<RClass*> convertable;
+
+        ClassEntry()
+        {
+            this->klass = NULL;
+        }
+    };
+    typedef std::vector<ClassEntry> ClassTable;
+
     static Table& get_living_table(){
         static Table table;
         return table;
     }
 
-    struct Data{
-        typedef std::map<std::string, std::map<std::string, bool> > ClassConvertableTable;
+    // Guards the living table, which VMs on other threads share.
+    static std::mutex& get_living_table_mutex(){
+        static std::mutex mutex;
+        return mutex;
+    }
 
+    // Lock-free queue of calls posted to a VM from other threads. Any
+    // thread may push; the VM thread takes the whole list at once and runs
+    // it in the order pushed.
+    class DispatchQueue
+    {
+        struct Node
+        {
+            Node* next;
+            std::function<void()> f;
+            // Runs even when the VM closes.
+            bool release;
+        };
+        std::atomic<Node*> head;
+        // Taken but not run yet; touched only on the VM thread.
+        Node* ready;
+
+        // Head of a closed queue.
+        static Node* closed_mark(){
+            static Node mark;
+            return &mark;
+        }
 
-        mrb_state* mrb;
+        // Takes the list pushed so far, in the order pushed.
+        Node* take(Node* replacement)
+        {
+            Node* n = head.exchange(replacement, std::memory_order_acquire);
+            Node* r = NULL;
+            while(n && n != closed_mark()){
+                Node* next = n->next;
+                n->next = r;
+                r = n;
+                n = next;
+            }
+            return r;
+        }
+
+        // Appends the list pushed so far to ready.
+        void take_ready(Node* replacement)
+        {
+            Node** tail = &ready;
+            while(*tail){
+                tail = &(*tail)->next;
+            }
+            *tail = take(replacement);
+        }
+
+        // Unlinks the next ready node, or returns NULL.
+        Node* next_ready()
+        {
+            Node* r = ready;
+            if(r){
+                ready = r->next;
+            }
+            return r;
+        }
+
+    public:
+        DispatchQueue() : head(NULL), ready(NULL)
+        {
+        }
+
+        ~DispatchQueue()
+        {
+            take_ready(closed_mark());
+            while(Node* r = next_ready()){
+                delete r;
+            }
+        }
+
+        // Returns false, dropping f, once the queue is closed.
+        bool push(std::function<void()> f, bool release)
+        {
+            Node* n = new Node;
+            n->f = std::move(f);
+            n->release = release;
+            n->next = head.load(std::memory_order_relaxed);
+            do{
+                if(n->next == closed_mark()){
+                    delete n;
+                    return false;
+                }
+            }while(!head.compare_exchange_weak(n->next, n, std::memory_order_release,
+                                               std::memory_order_relaxed));
+            return true;
+        }
+
+        // Runs the calls pushed so far and returns their number. Costs one
+        // load while the queue is empty. A call is unlinked before it runs,
+        // so that a run nested in a call goes on with the rest. Calls don't
+        // raise: FuncCall puts a block's exception in its future.
+        size_t run()
+        {
+            Node* h = head.load(std::memory_order_relaxed);
+            if(h == closed_mark() || (!h && !ready)){
+                return 0;
+            }
+            take_ready(NULL);
+            size_t count = 0;
+            while(Node* r = next_ready()){
+                r->f();
+                delete r;
+                count++;
+            }
+            return count;
+        }
+
+        // Called as the VM closes. Runs the releases still queued and drops
+        // the calls, which breaks their promises; later pushes fail.
+        void close()
+        {
+            take_ready(closed_mark());
+            while(Node* r = next_ready()){
+                if(r->release){
+                    r->f();
+                }
+                delete r;
+            }
+        }
+    };
+
+    // Number of VMs closed so far. Closing a VM empties the lookup caches
+    // of all threads.
+    static std::atomic<size_t>& get_closed_count(){
+        static std::atomic<size_t> count(0);
+        return count;
+    }
+
+    // VMs looked up last on a thread, so that a thread switching between a
+    // few VMs takes no lock. The entries are plain pointers, good only
+    // while closed equals the closed count, so a cache never hands out the
+    // data of a closed VM, nor matches a new VM at the same address. Plain
+    // data, so that the thread_local needs no initialization guard.
+    struct LookupCache
+    {
+        static const size_t SIZE = 8;
+        struct Entry
+        {
+            mrb_state* mrb;
+            Data* data;
+        };
+        Entry entries[SIZE];
+        // Entry hit last, which is checked first.
+        size_t last;
+        // Entry replaced next.
+        size_t next;
+        size_t closed;
+    };
+
+    static LookupCache& get_lookup_cache(){
+        static thread_local LookupCache cache;
+        return cache;
+    }
+
+    // Value held by MrubyRef handles.
+    struct Handle
+    {
+        mrb_value v;
+        size_t ref_count;
+    };
+    typedef std::vector<Handle> HandleTable;
+
+    // Script compiled by load_string().
+    struct Script
+    {
+        std::string code;
+        mrb_value proc;
+    };
+    typedef std::unordered_map<uint64_t, Script> ScriptCache;
+
+    struct Data : std::enable_shared_from_this<Data>{
+        typedef std::map<std::string, size_t> ClassIdTable;
+
+        // Set to NULL when the VM is closed, possibly by another thread.
+        std::atomic<mrb_state*> mrb;
         mrb_value avoid_gc_table;
-        ClassConvertableTable class_convertable_table;
+        ClassTable class_table;
+        ClassIdTable class_id_table;
+        // Class name pairs given to set_class_conversion().
+        std::vector<std::pair<std::string, std::string> > class_conversions;
         ObjectIdTable object_id_table;
         FreeIdArray free_id_array;
-
-        Data(){
+        // Thread which opened the bindings, or was last given the VM by
+        // set_vm_thread(); only it may touch the VM.
+        std::atomic<std::thread::id> owner;
+        DispatchQueue dispatch_queue;
+        // MrubyRef handles index handle_table. Their counts are plain
+        // integers since handles belong to the VM thread. While any is
+        // alive, self keeps this data alive, even past mrb_close().
+        // Once the VM is closed they may be released on any thread, under
+        // closed_mutex.
+        HandleTable handle_table;
+        FreeIdArray free_handles;
+        size_t live_handles;
+        std::shared_ptr<Data> self;
+        std::mutex closed_mutex;
+        // Compiled scripts by hash of their text. Their procs are pinned.
+        ScriptCache script_cache;
+        std::string script_cache_dir;
+        size_t script_cache_hits;
+        size_t script_cache_misses;
+        size_t script_cache_loaded;
+        // Anonymous class whose class method protect() calls, kept from
+        // the GC by an ivar of the MrubyBind module.
+        RClass* protect_class;
+
+        Data() : mrb(NULL), owner(std::this_thread::get_id()), live_handles(0),
+                 script_cache_hits(0), script_cache_misses(0), script_cache_loaded(0),
+                 protect_class(NULL){
 
         }
         ~Data(){
@@ -106,17 +461,210 @@ public:
             return free_id_array;
         }
 
-        void set_class_conversion(const std::string& s, const std::string& d, bool c){
-            class_convertable_table[s][d] = c;
+        bool on_vm_thread() const
+        {
+            return std::this_thread::get_id() == owner;
+        }
+
+        // Queues f to run on the VM thread at the next run_pending(). f is
+        // dropped if the VM closes first; false if it is closed already.
+        bool post(std::function<void()> f)
+        {
+            return dispatch_queue.push(std::move(f), false);
+        }
+
+        // Like post(), but f also runs when the VM closes first.
+        bool post_release(std::function<void()> f)
+        {
+            return dispatch_queue.push(std::move(f), true);
+        }
+
+        size_t run_pending()
+        {
+            return dispatch_queue.run();
+        }
+
+        // Returns a handle holding v with a count of one.
+        size_t new_handle(mrb_value v)
+        {
+            size_t h;
+            if(!free_handles.empty()){
+                h = free_handles.back();
+                free_handles.pop_back();
+            }
+            else{
+                h = handle_table.size();
+                handle_table.push_back(Handle());
+            }
+            handle_table[h].v = v;
+            handle_table[h].ref_count = 1;
+            if(live_handles++ == 0){
+                self = shared_from_this();
+            }
+            if(!mrb_immediate_p(v)){
+                pin(v);
+            }
+            return h;
+        }
+
+        void retain_handle(size_t h)
+        {
+            handle_table[h].ref_count++;
+        }
+
+        void release_handle(size_t h)
+        {
+            if(mrb){
+                if(on_vm_thread()){
+                    drop_handle(h);
+                    return;
+                }
+                Data* d = this;
+                if(post_release([d, h]{ d->release_handle(h); })){
+                    return;
+                }
+            }
+            // Declared first so that it may delete this after the unlock.
+            std::shared_ptr<Data> keep;
+            std::lock_guard<std::mutex> lock(closed_mutex);
+            keep = drop_handle(h);
+        }
+
+        // Returns self when the last handle goes, so that the caller
+        // decides when this may be deleted.
+        std::shared_ptr<Data> drop_handle(size_t h)
+        {
+            std::shared_ptr<Data> keep;
+            if(--handle_table[h].ref_count > 0){
+                return keep;
+            }
+            mrb_value v = handle_table[h].v;
+            if(mrb && !mrb_immediate_p(v)){
+                unpin(v);
+            }
+            handle_table[h].v = mrb_nil_value();
+            free_handles.push_back(h);
+            if(--live_handles == 0){
+                keep.swap(self);
+            }
+            return keep;
+        }
+
+        // Keeps v from being collected until the matching unpin().
+        void pin(mrb_value v)
+        {
+            ObjectInfo* oi = object_id_table.find(mrb_basic_ptr(v));
+            if(oi){
+                oi->ref_count++;
+                return;
+            }
+            size_t id;
+            if(!free_id_array.empty()){
+                id = free_id_array.back();
+                free_id_array.pop_back();
+                mrb_ary_set(mrb, avoid_gc_table, (mrb_int)id, v);
+            }
+            else{
+                id = new_id();
+                mrb_ary_push(mrb, avoid_gc_table, v);
+            }
+            object_id_table.insert(mrb_basic_ptr(v), ObjectInfo(id));
+        }
+
+        void unpin(mrb_value v)
+        {
+            ObjectInfo* oi = object_id_table.find(mrb_basic_ptr(v));
+            if(!oi || --oi->ref_count > 0){
+                return;
+            }
+            mrb_ary_set(mrb, avoid_gc_table, (mrb_int)oi->id, mrb_nil_value());
+            free_id_array.push_back(oi->id);
+            object_id_table.erase(mrb_basic_ptr(v));
+            // Shrink the table once more than half of it is free slots, so
+            // that the GC marks at most twice as many slots as there are
+            // pinned objects. Below 64 free slots they are only reused, so
+            // pinning and unpinning one value in a loop never compacts.
+            if(free_id_array.size() >= 64 &&
+               free_id_array.size() * 2 > (size_t)mrb_ary_len(mrb, avoid_gc_table)){
+                compact();
+            }
+        }
+
+        // Moves the pinned objects to the front of avoid_gc_table and cuts
+        // off the free slots.
+        void compact()
+        {
+            mrb_int len = mrb_ary_len(mrb, avoid_gc_table);
+            mrb_int next = 0;
+            for(mrb_int i = 0 ; i < len ; i++){
+                mrb_value v = mrb_ary_ref(mrb, avoid_gc_table, i);
+                if(mrb_nil_p(v)){
+                    continue;
+                }
+                object_id_table.find(mrb_basic_ptr(v))->id = next;
+                if(next != i){
+                    mrb_ary_set(mrb, avoid_gc_table, next, v);
+                }
+                next++;
+            }
+            mrb_ary_resize(mrb, avoid_gc_table, next);
+            free_id_array.clear();
+        }
+
+        void set_class(size_t id, const std::string& name, RClass* klass){
+            if(id >= class_table.size()){
+                class_table.resize(id + 1);
+            }
+            class_table[id].klass = klass;
+            class_id_table[name] = id;
+            for(size_t i = 0 ; i < class_conversions.size() ; i++){
+                if(class_conversions[i].first == name || class_conversions[i].second == name){
+                    link_class_conversion(class_conversions[i].first, class_conversions[i].second);
+                }
+            }
+        }
+
+        // Returns the class bound to id, or NULL.
+        RClass* get_class(size_t id){
+            return id < class_table.size() ? class_table[id].klass : NULL;
+        }
+
+        // Lets instances of the class named s be passed as the class named d.
+        // The names are kept, so either class may be bound later, or bound
+        // again, by set_class().
+        void set_class_conversion(const std::string& s, const std::string& d){
+            class_conversions.push_back(std::make_pair(s, d));
+            link_class_conversion(s, d);
+        }
+
+        // Adds the class named s to the classes accepted for d, once both
+        // are bound.
+        void link_class_conversion(const std::string& s, const std::string& d){
+            auto fs = class_id_table.find(s);
+            auto fd = class_id_table.find(d);
+            if(fs == class_id_table.end() || fd == class_id_table.end()){
+                return;
+            }
+            RClass* klass = class_table[fs->second].klass;
+            std::vector<RClass*>& convertable = class_table[fd->second].convertable;
+            if(std::find(convertable.begin(), convertable.end(), klass) == convertable.end()){
+                convertable.push_back(klass);
+            }
         }
 
-        bool is_convertable(const std::string& s, const std::string& d)
+        // Whether an instance of klass can be passed as the class bound to id.
+        bool is_convertable(RClass* klass, size_t id)
         {
-            auto fs = class_convertable_table.find(s);
-            if(fs != class_convertable_table.end()){
-                auto fd = fs->second.find(d);
-                if(fd != fs->second.end()){
-                    return fd->second;
+            if(id >= class_table.size()){
+                return false;
+            }
+            const ClassEntry& entry = class_table[id];
+            if(entry.klass == klass){
+                return true;
+            }
+            for(size_t i = 0 ; i < entry.convertable.size() ; i++){
+                if(entry.convertable[i] == klass){
+                    return true;
                 }
             }
             return false;
@@ -130,40 +678,95 @@ public:
 
     MrubyBindStatus(mrb_state* mrb, mrb_value avoid_gc_table){
 
-        Table& living_table = get_living_table();
         data = std::make_shared<Data>();
         data->mrb = mrb;
         data->avoid_gc_table = avoid_gc_table;
-        living_table[mrb] = data;
+        std::lock_guard<std::mutex> lock(get_living_table_mutex());
+        get_living_table()[mrb] = data;
     }
 
     ~MrubyBindStatus(){
 
-        Table& living_table = MrubyBindStatus::get_living_table();
-        living_table.erase(data->mrb);
-        data->mrb = NULL;
+        {
+            std::lock_guard<std::mutex> lock(get_living_table_mutex());
+            get_living_table().erase(data->mrb);
+            data->mrb = NULL;
+            get_closed_count()++;
+        }
+        // Queued calls hold FuncPtrs, which hold data: drop them now so
+        // that their promises break and data can go.
+        data->dispatch_queue.close();
 
     }
 
+    // Never dereferences mrb, so a closed VM can be asked about.
     static bool is_living(mrb_state* mrb){
-        Table& living_table = get_living_table();
-        if(living_table.find(mrb) != living_table.end()){
-            return living_table[mrb].get();
-        }
-        return false;
+        return lookup(mrb) != NULL;
     }
 
-    static Data_ptr search(mrb_state* mrb){
-        Table& living_table = get_living_table();
-        if(living_table.find(mrb) != living_table.end()){
-            return living_table[mrb];
+    // Returns the data of a VM, or NULL. Looking up the VM looked up last
+    // on the calling thread costs a load of the closed count and a pointer
+    // compare; the other VMs in the thread's cache cost a compare each.
+    // The living table owns the data of a living VM, so the pointer stays
+    // valid until the VM is closed.
+    static Data* lookup(mrb_state* mrb){
+        LookupCache& cache = get_lookup_cache();
+        if(cache.closed == get_closed_count().load(std::memory_order_acquire)){
+            if(cache.entries[cache.last].mrb == mrb){
+                return cache.entries[cache.last].data;
+            }
+            for(size_t i = 0 ; i < LookupCache::SIZE ; i++){
+                if(cache.entries[i].mrb == mrb){
+                    cache.last = i;
+                    return cache.entries[i].data;
+                }
+            }
         }
-        return Data_ptr(NULL);
+        return fill(mrb);
     }
 
+    // Like lookup(), but shares the ownership of the data.
+    static Data_ptr search(mrb_state* mrb){
+        Data* d = lookup(mrb);
+        return d ? d->shared_from_this() : Data_ptr();
+    }
 
+    // Runs what is posted to mrb, for the entry points that start the VM:
+    // load_string() and MrubyScript::run(). Bound functions don't, so that
+    // posted calls never run in the middle of another call.
+    static void run_posted(mrb_state* mrb){
+        if(Data* d = lookup(mrb)){
+            d->run_pending();
+        }
+    }
 
 private:
+    // Looks mrb up in the living table and remembers it in the calling
+    // thread's cache, which is emptied first if a VM closed since it was
+    // filled.
+    static Data* fill(mrb_state* mrb){
+        LookupCache& cache = get_lookup_cache();
+        std::lock_guard<std::mutex> lock(get_living_table_mutex());
+        size_t closed = get_closed_count().load(std::memory_order_relaxed);
+        if(cache.closed != closed){
+            for(size_t i = 0 ; i < LookupCache::SIZE ; i++){
+                cache.entries[i].mrb = NULL;
+                cache.entries[i].data = NULL;
+            }
+            cache.closed = closed;
+        }
+        Table& living_table = get_living_table();
+        auto it = living_table.find(mrb);
+        if(it == living_table.end()){
+            return NULL;
+        }
+        cache.last = cache.next;
+        cache.next = (cache.next + 1) % LookupCache::SIZE;
+        cache.entries[cache.last].mrb = mrb;
+        cache.entries[cache.last].data = it->second.get();
+        return it->second.get();
+    }
+
     std::shared_ptr<Data> data;
 };
 
@@ -180,29 +783,7 @@ public:
         if(!mrb_immediate_p(v))
         {
             mrbsp = MrubyBindStatus::search(mrb);
-            mrb_value avoid_gc_table = mrbsp->get_avoid_gc_table();
-            auto& object_id_table = mrbsp->get_object_id_table();
-            auto& free_id_array = mrbsp->get_free_id_array();
-            if(object_id_table.find(mrb_basic_ptr(v)) == object_id_table.end())
-            {
-                size_t new_id;
-                if(!free_id_array.empty())
-                {
-                    new_id = free_id_array.back();
-                    free_id_array.pop_back();
-                    mrb_ary_set(mrb, avoid_gc_table, (mrb_int)new_id, v);
-                }
-                else
-                {
-                    new_id = mrbsp->new_id();
-                    mrb_ary_push(mrb, avoid_gc_table, v);
-                }
-                object_id_table[mrb_basic_ptr(v)] = MrubyBindStatus::ObjectInfo(new_id);
-            }
-            else
-            {
-                object_id_table[mrb_basic_ptr(v)].ref_count++;
-            }
+            mrbsp->pin(v);
         }
         v_ = v;
 
@@ -220,16 +801,17 @@ public:
                 mrb_value v = v_;
                 if(!mrb_immediate_p(v))
                 {
-                    mrb_value avoid_gc_table = mrbsp->get_avoid_gc_table();
-                    auto& object_id_table = mrbsp->get_object_id_table();
-                    auto& free_id_array = mrbsp->get_free_id_array();
-                    auto& oi = object_id_table[mrb_basic_ptr(v)];
-                    oi.ref_count--;
-                    if(oi.ref_count <= 0)
-                    {
-                        mrb_ary_set(mrb, avoid_gc_table, (mrb_int)oi.id, mrb_nil_value());
-                        free_id_array.push_back(oi.id);
-                        object_id_table.erase(mrb_basic_ptr(v));
+                    if(mrbsp->on_vm_thread()){
+                        mrbsp->unpin(v);
+                    }
+                    else{
+                        // Released on another thread: unpin on the VM thread.
+                        MrubyBindStatus::Data* d = mrbsp.get();
+                        d->post_release([d, v]{
+                            if(d->mrb){
+                                d->unpin(v);
+                            }
+                        });
                     }
                 }
 
@@ -246,16 +828,21 @@ public:
 template<class T> using obj_ptr = std::shared_ptr<T>;
 //template<class T> using FuncPtr = std::shared_ptr<std::function<T> >;
 
+template<class T> struct FuncCall;
+
 template<class T> class FuncPtr{
     mrb_state* mrb;
+    mrb_value v;
     std::shared_ptr<std::function<T> > p;
 public:
-    FuncPtr(){
+    FuncPtr() : v(mrb_nil_value()){
 
     }
-    template<class D>FuncPtr(std::function<T>* pt, D d) : p(pt, d){
+    template<class D>FuncPtr(std::function<T>* pt, D d) : v(mrb_nil_value()), p(pt, d){
         mrb = d.get_mrb();
     }
+    FuncPtr(mrb_state* mrb, mrb_value v, const std::shared_ptr<std::function<T> >& p) : mrb(mrb), v(v), p(p){
+    }
     ~FuncPtr(){
 
     }
@@ -265,6 +852,27 @@ public:
     bool is_living() const{
         return MrubyBindStatus::is_living(mrb);
     }
+    mrb_state* get_mrb() const{
+        return mrb;
+    }
+    // Block value, or nil if not made from a block.
+    mrb_value get_v() const{
+        return v;
+    }
+    // Calls the block once per element of [first, last); see BlockCall.
+    template<class In, class Out> Out call_each(In first, In last, Out out) const{
+        return FuncCall<T>::call_each(*this, first, last, out);
+    }
+    template<class In> void call_each(In first, In last) const{
+        FuncCall<T>::call_each(*this, first, last);
+    }
+    // Calls the function on the VM thread. From another thread the call
+    // waits in the VM's queue until the VM thread next runs a script or
+    // calls run_pending(); on the VM thread it runs at once. The result,
+    // or the exception thrown or raised by the block, is in the future.
+    template<class... A> typename FuncCall<T>::future call_async(A... a) const{
+        return FuncCall<T>::call_async(*this, a...);
+    }
     std::function<T>& func() const{
         if(!p.get()){
             throw std::runtime_error("empty function.");
@@ -295,57 +903,528 @@ template<class T> Deleter<T> set_avoid_gc(mrb_state* mrb, mrb_value v){
     return Deleter<T>(mrb, v);
 }
 
-template<class T> obj_ptr<T> make_obj_ptr(Deleter<T> d, T t){
-    T* pt = new T();
-    *pt = t;
-    return obj_ptr<T>(pt, d);
-}
-
 template<class T> FuncPtr<T> make_FuncPtr(Deleter<std::function<T> > d, std::function<T> t){
-    std::function<T>* pt = new std::function<T>();
-    *pt = t;
-    return FuncPtr<T>(pt, d);
+    return FuncPtr<T>(new std::function<T>(std::move(t)), d);
 }
 
 template <class T>
 struct Type;
 
-class MrubyRef{
-    mrb_state* mrb;
-    std::shared_ptr<mrb_value> v;
-public:
-
-    MrubyRef();
-    MrubyRef(mrb_state* mrb, const mrb_value& v);
-    ~MrubyRef();
+// Name of T in error messages. Arrays and Hashes also name their
+// elements, e.g. "Array of Fixnum".
+template<class T> struct TypeName{
+    static const char* get(){ return Type<T>::TYPE_NAME; }
+};
 
-    bool is_living() const;
-    mrb_state* get_mrb() const;
-    mrb_value get_v()const;
-    bool empty() const;
-    bool test() const;
-    bool obj_equal(const MrubyRef& r) const;
-    std::string to_s() const;
-    int to_i() const;
-    float to_float() const;
-    double to_double() const;
+template<class T> const char* type_name(){
+    return TypeName<typename std::decay<T>::type>::get();
+}
 
-    MrubyRef call(std::string name);
+// Converts C++ arguments for a block into argv.
+template<class... P>
+struct BlockArgs{
+    // One element per parameter of a std::tuple or std::pair.
+    template<class... A>
+    static void set(mrb_state* mrb, mrb_value* argv, const std::tuple<A...>& t){
+        set(mrb, argv, t, make_index_sequence<sizeof...(P)>());
+    }
+    template<class A, class B>
+    static void set(mrb_state* mrb, mrb_value* argv, const std::pair<A, B>& t){
+        set(mrb, argv, t, make_index_sequence<sizeof...(P)>());
+    }
+    // The argument itself for a block taking one parameter.
+    template<class A>
+    static void set(mrb_state* mrb, mrb_value* argv, const A& a){
+        static_assert(sizeof...(P) == 1, "give a std::tuple of the block arguments.");
+        argv[0] = Type<typename std::tuple_element<0, std::tuple<P...> >::type>::ret(mrb, a);
+    }
+    template<class A, size_t... I>
+    static void set(mrb_state* mrb, mrb_value* argv, const A& t, index_sequence<I...>){
+        int dummy[] = {0, ((void)(argv[I] = Type<P>::ret(mrb, std::get<I>(t))), 0)...};
+        (void)mrb; (void)argv; (void)t; (void)dummy;
+    }
+};
 
-#include "mrubybind_call_generated.h"
+// Yields to a block with arguments converted by Type<>.
+//
+// call_each() yields once per element of [first, last), all under one arena
+// save and with one argument buffer, and writes each result to out, which
+// may point into a preallocated container. It returns the end of out.
+template<class R, class... P>
+struct BlockCall{
+    static R call(mrb_state* mrb, mrb_value v, P... a){
+        MrubyArenaStore mas(mrb);
+        mrb_value argv[sizeof...(P) + 1] = {Type<P>::ret(mrb, a)...};
+        return Type<R>::get(mrb, mrb_yield_argv(mrb, v, sizeof...(P), argv));
+    }
+    template<class In, class Out>
+    static Out call_each(mrb_state* mrb, mrb_value v, In first, In last, Out out){
+        int ai = mrb_gc_arena_save(mrb);
+        mrb_value argv[sizeof...(P) + 1];
+        for(; first != last; ++first){
+            BlockArgs<P...>::set(mrb, argv, *first);
+            *out = Type<R>::get(mrb, mrb_yield_argv(mrb, v, sizeof...(P), argv));
+            ++out;
+            mrb_gc_arena_restore(mrb, ai);
+        }
+        return out;
+    }
+};
 
+template<class... P>
+struct BlockCall<void, P...>{
+    static void call(mrb_state* mrb, mrb_value v, P... a){
+        MrubyArenaStore mas(mrb);
+        mrb_value argv[sizeof...(P) + 1] = {Type<P>::ret(mrb, a)...};
+        mrb_yield_argv(mrb, v, sizeof...(P), argv);
+    }
+    template<class In>
+    static void call_each(mrb_state* mrb, mrb_value v, In first, In last){
+        int ai = mrb_gc_arena_save(mrb);
+        mrb_value argv[sizeof...(P) + 1];
+        for(; first != last; ++first){
+            BlockArgs<P...>::set(mrb, argv, *first);
+            mrb_yield_argv(mrb, v, sizeof...(P), argv);
+            mrb_gc_arena_restore(mrb, ai);
+        }
+    }
 };
 
-//===========================================================================
-// C <-> mruby type converter.
+// Runs f(mrb, data) with a jump buffer of its own, so that an exception
+// raised in it stops here, inside the VM or not, with the VM's frames
+// restored. Returns false, with the exception's class and message in
+// error, if one was raised. mrb->exc is left as it was on entry. A raise
+// skips the frames of f, so f must not hold objects with destructors.
+bool protect(mrb_state* mrb, void (*f)(mrb_state*, void*), void* data, std::string& error);
 
-//template <class T>
-//struct Type {
-  // Type name used for error message.
-  // static const char TYPE_NAME[];
+// Sets a promise to the result of a call.
+template<class R>
+struct PromiseSet{
+    template<class F, class... A>
+    static void set(std::promise<R>& p, F& f, A&... a){
+        p.set_value(f(a...));
+    }
+    // Result of a block, which may not convert.
+    static void set_value(std::promise<R>& p, mrb_state* mrb, mrb_value v){
+        if(!Type<R>::check(mrb, v)){
+            throw std::runtime_error(std::string("can't convert ") + mrb_obj_classname(mrb, v) +
+                                     " into " + type_name<R>());
+        }
+        p.set_value(Type<R>::get(mrb, v));
+    }
+};
 
-  // Returns whether the given mrb_value can be converted into type T.
-  //static int check(mrb_value v) = 0;
+template<>
+struct PromiseSet<void>{
+    template<class F, class... A>
+    static void set(std::promise<void>& p, F& f, A&... a){
+        f(a...);
+        p.set_value();
+    }
+    static void set_value(std::promise<void>& p, mrb_state*, mrb_value){
+        p.set_value();
+    }
+};
+
+template<class R, class... P> struct FuncCall<R(P...)>{
+    typedef std::future<R> future;
+    typedef std::tuple<typename std::decay<P>::type...> Args;
+
+    static void check(const FuncPtr<R(P...)>& f){
+        if(mrb_type(f.get_v()) != MRB_TT_PROC){
+            throw std::runtime_error("call_each needs a FuncPtr made from a block.");
+        }
+    }
+    template<class In, class Out>
+    static Out call_each(const FuncPtr<R(P...)>& f, In first, In last, Out out){
+        check(f);
+        return BlockCall<R, P...>::call_each(f.get_mrb(), f.get_v(), first, last, out);
+    }
+    template<class In>
+    static void call_each(const FuncPtr<R(P...)>& f, In first, In last){
+        check(f);
+        BlockCall<R, P...>::call_each(f.get_mrb(), f.get_v(), first, last);
+    }
+
+    static future call_async(const FuncPtr<R(P...)>& f, P... a){
+        std::shared_ptr<std::promise<R> > p = std::make_shared<std::promise<R> >();
+        future r = p->get_future();
+        MrubyBindStatus::Data_ptr d = MrubyBindStatus::search(f.get_mrb());
+        if(!d){
+            p->set_exception(std::make_exception_ptr(std::runtime_error("mruby is closed.")));
+            return r;
+        }
+        Args args(a...);
+        std::function<void()> call = [f, p, args]{
+            run(f, *p, args, make_index_sequence<sizeof...(P)>());
+        };
+        if(d->on_vm_thread()){
+            call();
+        }
+        else if(!d->post(std::move(call))){
+            // Closed since the search: post() dropped the call.
+            p->set_exception(std::make_exception_ptr(std::runtime_error("mruby is closed.")));
+        }
+        return r;
+    }
+
+    template<size_t... I>
+    static void run(const FuncPtr<R(P...)>& f, std::promise<R>& p, const Args& args, index_sequence<I...>){
+        try{
+            if(mrb_type(f.get_v()) == MRB_TT_PROC){
+                yield<I...>(f, p, args);
+            }
+            else{
+                Args a(args);
+                PromiseSet<R>::set(p, f.func(), std::get<I>(a)...);
+            }
+        }
+        catch(...){
+            p.set_exception(std::current_exception());
+        }
+    }
+
+    // Block call run by protect().
+    struct Yield{
+        mrb_value v;
+        const Args* args;
+        mrb_value result;
+    };
+
+    template<size_t... I>
+    static void yield_body(mrb_state* mrb, void* data){
+        Yield* y = static_cast<Yield*>(data);
+        mrb_value argv[sizeof...(P) + 1] = {Type<P>::ret(mrb, std::get<I>(*y->args))...};
+        y->result = mrb_yield_argv(mrb, y->v, sizeof...(P), argv);
+    }
+
+    // Calls the block under protect(), so that what it raises goes to the
+    // future instead of unwinding whatever ran the queue.
+    template<size_t... I>
+    static void yield(const FuncPtr<R(P...)>& f, std::promise<R>& p, const Args& args){
+        mrb_state* mrb = f.get_mrb();
+        MrubyArenaStore mas(mrb);
+        Yield y = {f.get_v(), &args, mrb_nil_value()};
+        std::string error;
+        if(!protect(mrb, &yield_body<I...>, &y, error)){
+            throw std::runtime_error(error);
+        }
+        PromiseSet<R>::set_value(p, mrb, y.result);
+    }
+};
+
+// Block borrowed for the duration of a bound function call. It neither
+// allocates nor pins the block, so it must not be kept after the call
+// returns; use FuncPtr for that.
+template<class T> class FuncRef;
+
+template<class R, class... P> class FuncRef<R(P...)>{
+    mrb_state* mrb;
+    mrb_value v;
+public:
+    FuncRef(mrb_state* mrb, mrb_value v) : mrb(mrb), v(v){
+    }
+    mrb_state* get_mrb() const{
+        return mrb;
+    }
+    mrb_value get_v() const{
+        return v;
+    }
+    operator bool() const {
+        return !mrb_nil_p(v);
+    }
+    R operator()(P... a) const{
+        return BlockCall<R, P...>::call(mrb, v, a...);
+    }
+    // Calls the block once per element of [first, last); see BlockCall.
+    template<class In, class Out> Out call_each(In first, In last, Out out) const{
+        return BlockCall<R, P...>::call_each(mrb, v, first, last, out);
+    }
+    template<class In> void call_each(In first, In last) const{
+        BlockCall<R, P...>::call_each(mrb, v, first, last);
+    }
+};
+
+// Storage of a FuncPtr made from a block: the pin and the std::function
+// share one allocation with the shared_ptr control block. The function
+// captures only the holder, so it fits in std::function's local buffer.
+template<class T> struct FuncHolder;
+
+template<class R, class... P> struct FuncHolder<R(P...)>{
+    Deleter<std::function<R(P...)> > d;
+    mrb_state* mrb;
+    mrb_value v;
+    std::function<R(P...)> f;
+
+    FuncHolder(mrb_state* mrb, mrb_value v) : d(mrb, v), mrb(mrb), v(v){
+        FuncHolder* h = this;
+        f = [h](P... a){
+            return BlockCall<R, P...>::call(h->mrb, h->v, a...);
+        };
+    }
+    ~FuncHolder(){
+        d(NULL);
+    }
+    FuncHolder(const FuncHolder&) = delete;
+    FuncHolder& operator=(const FuncHolder&) = delete;
+};
+
+// Ruby method which as<T>() calls to convert a value that isn't a T, or
+// NULL if there is none.
+template<class T, class Enable = void>
+struct Conversion{
+    static const char* method(){ return NULL; }
+};
+
+template<class T>
+struct Conversion<T, typename std::enable_if<std::is_integral<T>::value &&
+                                             !std::is_same<T, bool>::value>::type>{
+    static const char* method(){ return "to_i"; }
+};
+
+template<class T>
+struct Conversion<T, typename std::enable_if<std::is_floating_point<T>::value>::type>{
+    static const char* method(){ return "to_f"; }
+};
+
+template<>
+struct Conversion<std::string>{
+    static const char* method(){ return "to_s"; }
+};
+
+// Makes v pass Type<T>::check, calling the Conversion<T> method only if it
+// doesn't already. Returns false if it can't.
+template<class T>
+bool convert_value(mrb_state* mrb, mrb_value& v){
+    if(Type<T>::check(mrb, v)){
+        return true;
+    }
+    const char* method = Conversion<T>::method();
+    if(!method){
+        return false;
+    }
+    mrb_sym sym = mrb_intern_cstr(mrb, method);
+    if(!mrb_respond_to(mrb, v, sym)){
+        return false;
+    }
+    v = mrb_funcall_argv(mrb, v, sym, 0, NULL);
+    return Type<T>::check(mrb, v) != 0;
+}
+
+template<class T>
+T value_as(mrb_state* mrb, mrb_value v){
+    if(!mrb){
+        throw std::runtime_error("empty reference.");
+    }
+    MrubyArenaStore mas(mrb);
+    mrb_value converted = v;
+    if(!convert_value<T>(mrb, converted)){
+        throw std::runtime_error(std::string("can't convert ") + mrb_obj_classname(mrb, v) +
+                                 " into " + type_name<T>());
+    }
+    return Type<T>::get(mrb, converted);
+}
+
+template<class T>
+bool value_try_as(mrb_state* mrb, mrb_value v, T& out){
+    if(!mrb){
+        return false;
+    }
+    MrubyArenaStore mas(mrb);
+    if(!convert_value<T>(mrb, v)){
+        return false;
+    }
+    out = Type<T>::get(mrb, v);
+    return true;
+}
+
+class MrubyValueView;
+template<class T> class ArrayView;
+template<class K, class V> class HashView;
+template<class View> class PinnedView;
+
+// Reference to a mruby value which keeps it from being collected. It is
+// a slot in the VM's handle table, so making one costs no allocation and
+// copies bump a plain count. Copy it on the VM thread only; it may be
+// released on another thread, which defers the release to the VM thread.
+class MrubyRef{
+    MrubyBindStatus::Data* data;
+    size_t handle;
+public:
+
+    MrubyRef() : data(NULL), handle(0){
+    }
+    MrubyRef(mrb_state* mrb, const mrb_value& v);
+    MrubyRef(const MrubyValueView& v);
+    MrubyRef(const MrubyRef& r) : data(r.data), handle(r.handle){
+        if(data){
+            data->retain_handle(handle);
+        }
+    }
+    MrubyRef(MrubyRef&& r) : data(r.data), handle(r.handle){
+        r.data = NULL;
+    }
+    ~MrubyRef(){
+        if(data){
+            data->release_handle(handle);
+        }
+    }
+    MrubyRef& operator=(MrubyRef r){
+        std::swap(data, r.data);
+        std::swap(handle, r.handle);
+        return *this;
+    }
+
+    bool is_living() const;
+    mrb_state* get_mrb() const{
+        return data ? data->get_mrb() : NULL;
+    }
+    mrb_value get_v() const{
+        return data ? data->handle_table[handle].v : mrb_nil_value();
+    }
+    MrubyValueView view() const;
+
+    // Value as a T, read by Type<T>. A number or string of another type is
+    // converted with to_i, to_f or to_s; anything else that isn't a T
+    // throws std::runtime_error, or makes try_as() return false.
+    template<class T> T as() const{
+        return value_as<T>(get_mrb(), get_v());
+    }
+    template<class T> bool try_as(T& out) const{
+        return value_try_as<T>(get_mrb(), get_v(), out);
+    }
+
+    // Range over an Array or Hash read in place, with elements converted
+    // as they are read. The range pins the collection while it lives.
+    // Throws std::runtime_error unless every element converts.
+    template<class T> PinnedView<ArrayView<T> > array_view() const;
+    template<class K, class V> PinnedView<HashView<K, V> > hash_view() const;
+
+    bool empty() const;
+    bool test() const;
+    bool obj_equal(const MrubyRef& r) const;
+    std::string to_s() const;
+    int to_i() const;
+    float to_float() const;
+    double to_double() const;
+
+    MrubyRef call(const std::string& name);
+
+    template<class... P> MrubyRef call(const std::string& name, P... a){
+        mrb_state* mrb = get_mrb();
+        MrubyArenaStore mas(mrb);
+        mrb_value argv[sizeof...(P) + 1] = {Type<P>::ret(mrb, a)...};
+        return MrubyRef(mrb, mrb_funcall_argv(mrb, get_v(), mrb_intern_cstr(mrb, name.c_str()), sizeof...(P), argv));
+    }
+
+};
+
+// mruby value used without pinning it, such as an argument of a bound
+// function that isn't kept after the call. Make a MrubyRef from it to keep
+// it.
+class MrubyValueView{
+    mrb_state* mrb;
+    mrb_value v;
+public:
+
+    MrubyValueView() : mrb(NULL), v(mrb_nil_value()){
+    }
+    MrubyValueView(mrb_state* mrb, const mrb_value& v) : mrb(mrb), v(v){
+    }
+
+    mrb_state* get_mrb() const{
+        return mrb;
+    }
+    mrb_value get_v() const{
+        return v;
+    }
+    // See MrubyRef::as().
+    template<class T> T as() const{
+        return value_as<T>(mrb, v);
+    }
+    template<class T> bool try_as(T& out) const{
+        return value_try_as<T>(mrb, v, out);
+    }
+    bool empty() const;
+    bool test() const;
+    bool obj_equal(const MrubyValueView& r) const;
+    std::string to_s() const;
+    int to_i() const;
+    float to_float() const;
+    double to_double() const;
+
+    MrubyRef call(const std::string& name) const;
+
+    template<class... P> MrubyRef call(const std::string& name, P... a) const{
+        MrubyArenaStore mas(mrb);
+        mrb_value argv[sizeof...(P) + 1] = {Type<P>::ret(mrb, a)...};
+        return MrubyRef(mrb, mrb_funcall_argv(mrb, v, mrb_intern_cstr(mrb, name.c_str()), sizeof...(P), argv));
+    }
+
+};
+
+// Method of an object, or a class method if the object is a class, to be
+// called many times. The name is interned once, and the method is looked
+// up on the first call and again only when the receiver's class changes,
+// e.g. by a singleton method. A method redefined after that isn't seen:
+// call invalidate() once it may have been. Until then the old method, kept
+// from the GC, still runs.
+class MrubyMethod{
+    MrubyRef self;
+    mrb_sym sym;
+    RClass* klass;
+    RClass* owner;
+    MrubyRef proc;
+
+    mrb_value invoke(mrb_int argc, const mrb_value* argv);
+public:
+
+    MrubyMethod();
+    MrubyMethod(const MrubyRef& self, const std::string& name);
+
+    const MrubyRef& get_self() const;
+    mrb_sym get_sym() const;
+
+    // Drops the method found, so that the next call looks it up again.
+    void invalidate();
+
+    template<class... P> MrubyRef call(P... a){
+        mrb_state* mrb = self.get_mrb();
+        MrubyArenaStore mas(mrb);
+        mrb_value argv[sizeof...(P) + 1] = {Type<P>::ret(mrb, a)...};
+        return MrubyRef(mrb, invoke(sizeof...(P), argv));
+    }
+
+};
+
+// Script compiled once, to be run at the top level many times without
+// parsing. The file name shows in backtraces and __FILE__. A syntax error
+// leaves the script empty and the exception in mrb->exc; so does run()
+// for an exception raised by the script, which then returns nil.
+class MrubyScript{
+    MrubyRef proc;
+    std::string filename;
+public:
+
+    MrubyScript();
+    MrubyScript(mrb_state* mrb, const std::string& code, const std::string& filename = "");
+
+    bool empty() const;
+    const std::string& get_filename() const;
+    MrubyRef run();
+
+};
+
+//===========================================================================
+// C <-> mruby type converter.
+
+//template <class T>
+//struct Type {
+  // Type name used for error message.
+  // static const char TYPE_NAME[];
+
+  // Returns whether the given mrb_value can be converted into type T.
+  //static int check(mrb_value v) = 0;
 
   // Converts mrb_value to type T value.
   //static T get(mrb_value v) = 0;
@@ -354,23 +1433,116 @@ public:
   //static mrb_value ret(mrb_state*, T i) = 0;
 //};
 
+// Integer types. Values outside the range of T don't pass check(), so a
+// bad argument raises TypeError before anything is converted. Floats are
+// accepted only when they hold an integer.
+template<class T>
+struct TypeInteger {
+  static bool in_range(mrb_int i) {
+    return std::is_signed<T>::value ?
+        (intmax_t)i >= (intmax_t)std::numeric_limits<T>::min() &&
+        (intmax_t)i <= (intmax_t)std::numeric_limits<T>::max() :
+        i >= 0 && (uintmax_t)i <= (uintmax_t)std::numeric_limits<T>::max();
+  }
+  static bool in_range(mrb_float f) {
+    return f == std::floor(f) &&
+        f >= (mrb_float)std::numeric_limits<T>::min() &&
+        f < std::ldexp((mrb_float)1, std::numeric_limits<T>::digits);
+  }
+  static int check(mrb_state*, mrb_value v) {
+    return (mrb_fixnum_p(v) && in_range(mrb_fixnum(v))) ||
+        (mrb_float_p(v) && in_range(mrb_float(v)));
+  }
+  static T get(mrb_state* mrb, mrb_value v) { (void)mrb; return mrb_fixnum_p(v) ? (T)mrb_fixnum(v) : (T)mrb_float(v); }
+  // Returns a Fixnum, or a Float when the value is out of Fixnum range but
+  // still exact as a Float. Raises RangeError otherwise.
+  static mrb_value ret(mrb_state* mrb, T i) {
+    if(std::is_signed<T>::value ?
+       (intmax_t)i >= (intmax_t)MRB_INT_MIN && (intmax_t)i <= (intmax_t)MRB_INT_MAX :
+       (uintmax_t)i <= (uintmax_t)MRB_INT_MAX){
+      return mrb_fixnum_value((mrb_int)i);
+    }
+    // in_range() keeps the cast back to T defined.
+    mrb_float f = (mrb_float)i;
+    if(in_range(f) && (T)f == i){
+      return mrb_float_value(mrb, f);
+    }
+    mrb_raisef(mrb, E_RANGE_ERROR, "integer %S too big to convert into Fixnum",
+               mrb_str_new_cstr(mrb, std::to_string(i).c_str()));
+    return mrb_nil_value();
+  }
+};
+
 // Fixnum
 template<>
-struct Type<int> {
+struct Type<int> :public TypeInteger<int> {
+  static const char TYPE_NAME[];
+};
+
+template<>
+struct Type<unsigned int> :public TypeInteger<unsigned int> {
+  static const char TYPE_NAME[];
+};
+
+template<>
+struct Type<signed char> :public TypeInteger<signed char> {
+  static const char TYPE_NAME[];
+};
+
+template<>
+struct Type<unsigned char> :public TypeInteger<unsigned char> {
+  static const char TYPE_NAME[];
+};
+
+template<>
+struct Type<short> :public TypeInteger<short> {
+  static const char TYPE_NAME[];
+};
+
+template<>
+struct Type<unsigned short> :public TypeInteger<unsigned short> {
+  static const char TYPE_NAME[];
+};
+
+template<>
+struct Type<long> :public TypeInteger<long> {
   static const char TYPE_NAME[];
-  static int check(mrb_state*, mrb_value v) { return mrb_fixnum_p(v) || mrb_float_p(v); }
-  static int get(mrb_state* mrb, mrb_value v) { (void)mrb; return mrb_fixnum_p(v) ? mrb_fixnum(v) : mrb_float(v); }
-  static mrb_value ret(mrb_state*, int i) { return mrb_fixnum_value(i); }
 };
 
 template<>
-struct Type<unsigned int> {
+struct Type<unsigned long> :public TypeInteger<unsigned long> {
   static const char TYPE_NAME[];
-  static int check(mrb_state*, mrb_value v) { return mrb_fixnum_p(v) || mrb_float_p(v); }
-  static unsigned int get(mrb_state* mrb, mrb_value v) { (void)mrb; return mrb_fixnum_p(v) ? mrb_fixnum(v) : mrb_float(v); }
-  static mrb_value ret(mrb_state*, unsigned int i) { return mrb_fixnum_value(i); }
 };
 
+template<>
+struct Type<long long> :public TypeInteger<long long> {
+  static const char TYPE_NAME[];
+};
+
+template<>
+struct Type<unsigned long long> :public TypeInteger<unsigned long long> {
+  static const char TYPE_NAME[];
+};
+
+// Integers other than int are named by sign and width in errors, e.g.
+// "can't convert Fixnum into uint8", since they all take a Fixnum.
+template<class T> struct IntegerTypeName{
+    static const char* get(){
+        static const std::string name = std::string(std::is_signed<T>::value ? "int" : "uint") +
+            std::to_string(std::numeric_limits<T>::digits + (std::is_signed<T>::value ? 1 : 0));
+        return name.c_str();
+    }
+};
+template<> struct TypeName<unsigned int> :public IntegerTypeName<unsigned int> {};
+template<> struct TypeName<signed char> :public IntegerTypeName<signed char> {};
+template<> struct TypeName<unsigned char> :public IntegerTypeName<unsigned char> {};
+template<> struct TypeName<short> :public IntegerTypeName<short> {};
+template<> struct TypeName<unsigned short> :public IntegerTypeName<unsigned short> {};
+template<> struct TypeName<long> :public IntegerTypeName<long> {};
+template<> struct TypeName<unsigned long> :public IntegerTypeName<unsigned long> {};
+template<> struct TypeName<long long> :public IntegerTypeName<long long> {};
+template<> struct TypeName<unsigned long long> :public IntegerTypeName<unsigned long long> {};
+
 // float
 template<>
 struct Type<float> {
@@ -402,7 +1574,7 @@ template<>
 struct Type<std::string> {
   static const char TYPE_NAME[];
   static int check(mrb_state*, mrb_value v) { return mrb_string_p(v); }
-  static const std::string get(mrb_state* mrb, mrb_value v) { (void)mrb; return std::string(RSTRING_PTR(v), RSTRING_LEN(v)); }
+  static std::string get(mrb_state* mrb, mrb_value v) { (void)mrb; return std::string(RSTRING_PTR(v), RSTRING_LEN(v)); }
   static mrb_value ret(mrb_state* mrb, const std::string& s) { return mrb_str_new(mrb, s.c_str(), s.size()); }
 };
 
@@ -410,7 +1582,7 @@ template<>
 struct Type<const std::string> {
   static const char TYPE_NAME[];
   static int check(mrb_state*, mrb_value v) { return mrb_string_p(v); }
-  static const std::string get(mrb_state* mrb, mrb_value v) { (void)mrb; return std::string(RSTRING_PTR(v), RSTRING_LEN(v)); }
+  static std::string get(mrb_state* mrb, mrb_value v) { (void)mrb; return std::string(RSTRING_PTR(v), RSTRING_LEN(v)); }
   static mrb_value ret(mrb_state* mrb, const std::string& s) { return mrb_str_new(mrb, s.c_str(), s.size()); }
 };
 
@@ -418,10 +1590,44 @@ template<>
 struct Type<const std::string&> {
   static const char TYPE_NAME[];
   static int check(mrb_state*, mrb_value v) { return mrb_string_p(v); }
-  static const std::string get(mrb_state* mrb, mrb_value v) { (void)mrb; return std::string(RSTRING_PTR(v), RSTRING_LEN(v)); }
+  static std::string get(mrb_state* mrb, mrb_value v) { (void)mrb; return std::string(RSTRING_PTR(v), RSTRING_LEN(v)); }
   static mrb_value ret(mrb_state* mrb, const std::string& s) { return mrb_str_new(mrb, s.c_str(), s.size()); }
 };
 
+// Bytes of a String, read in place. Valid only during the call.
+struct ByteSpan {
+  const unsigned char* data;
+  size_t size;
+
+  ByteSpan() : data(NULL), size(0) {}
+  ByteSpan(const void* data, size_t size)
+      : data(static_cast<const unsigned char*>(data)), size(size) {}
+
+  const unsigned char* begin() const { return data; }
+  const unsigned char* end() const { return data + size; }
+  bool empty() const { return size == 0; }
+  unsigned char operator[](size_t i) const { return data[i]; }
+};
+
+template<>
+struct Type<ByteSpan> {
+  static const char TYPE_NAME[];
+  static int check(mrb_state*, mrb_value v) { return mrb_string_p(v); }
+  static ByteSpan get(mrb_state* mrb, mrb_value v) { (void)mrb; return ByteSpan(RSTRING_PTR(v), RSTRING_LEN(v)); }
+  static mrb_value ret(mrb_state* mrb, ByteSpan s) { return mrb_str_new(mrb, (const char*)s.data, s.size); }
+};
+
+#if __cplusplus >= 201703L
+// Points into the String buffer. Valid only during the call.
+template<>
+struct Type<std::string_view> {
+  static constexpr char TYPE_NAME[] = "String";
+  static int check(mrb_state*, mrb_value v) { return mrb_string_p(v); }
+  static std::string_view get(mrb_state* mrb, mrb_value v) { (void)mrb; return std::string_view(RSTRING_PTR(v), RSTRING_LEN(v)); }
+  static mrb_value ret(mrb_state* mrb, std::string_view s) { return mrb_str_new(mrb, s.data(), s.size()); }
+};
+#endif
+
 // Boolean
 template<>
 struct Type<bool> {
@@ -445,38 +1651,25 @@ struct TypeFuncBase{
     static const char TYPE_NAME[];
 };
 
-template<class R>
-struct Type<FuncPtr<R()> > :public TypeFuncBase {
+template<class R, class... P>
+struct Type<FuncPtr<R(P...)> > :public TypeFuncBase {
   static int check(mrb_state*, mrb_value v) { return mrb_type(v) == MRB_TT_PROC; }
-  static FuncPtr<R()> get(mrb_state* mrb, mrb_value v) {
-      Deleter<std::function<R()> > d = set_avoid_gc<std::function<R()> >(mrb, v);
-      return make_FuncPtr<R()>(d, [=](){
-          MrubyArenaStore mas(mrb);
-          return Type<R>::get(mrb, mrb_yield(mrb, v, mrb_nil_value()));
-      });
+  static FuncPtr<R(P...)> get(mrb_state* mrb, mrb_value v) {
+      std::shared_ptr<FuncHolder<R(P...)> > h = std::make_shared<FuncHolder<R(P...)> >(mrb, v);
+      return FuncPtr<R(P...)>(mrb, v, std::shared_ptr<std::function<R(P...)> >(h, &h->f));
   }
-  static mrb_value ret(mrb_state* mrb, FuncPtr<R()> p) {
+  static mrb_value ret(mrb_state* mrb, FuncPtr<R(P...)> p) {
       // don't call.
-      throw std::runtime_error("don't call Type<FuncPtr<R()> >::ret");
+      throw std::runtime_error("don't call Type<FuncPtr<R(P...)> >::ret");
       (void)mrb; (void)p; return mrb_nil_value();
   }
 };
 
-template<>
-struct Type<FuncPtr<void()> > :public TypeFuncBase {
+template<class R, class... P>
+struct Type<FuncRef<R(P...)> > :public TypeFuncBase {
   static int check(mrb_state*, mrb_value v) { return mrb_type(v) == MRB_TT_PROC; }
-  static FuncPtr<void()> get(mrb_state* mrb, mrb_value v) {
-      Deleter<std::function<void()> > d = set_avoid_gc<std::function<void()> >(mrb, v);
-      return make_FuncPtr<void()>(d, [=](){
-          MrubyArenaStore mas(mrb);
-          mrb_yield(mrb, v, mrb_nil_value());
-      });
-  }
-  static mrb_value ret(mrb_state* mrb, FuncPtr<void()> p) {
-      // don't call.
-      throw std::runtime_error("don't call Type<FuncPtr<void()> >::ret");
-      (void)mrb; (void)p; return mrb_nil_value();
-  }
+  static FuncRef<R(P...)> get(mrb_state* mrb, mrb_value v) { return FuncRef<R(P...)>(mrb, v); }
+  static mrb_value ret(mrb_state*, FuncRef<R(P...)> p) { return p.get_v(); }
 };
 
 // mruby value
@@ -488,8 +1681,331 @@ struct Type<MrubyRef> {
   static mrb_value ret(mrb_state*, MrubyRef r) { return r.get_v(); }
 };
 
+template<>
+struct Type<MrubyValueView> {
+  static const char TYPE_NAME[];
+  static int check(mrb_state*, mrb_value) { return 1; }
+  static MrubyValueView get(mrb_state* mrb, mrb_value v) { return MrubyValueView(mrb, v); }
+  static mrb_value ret(mrb_state*, MrubyValueView r) { return r.get_v(); }
+};
+
+// Array <-> std::vector
+struct TypeArrayBase{
+    static const char TYPE_NAME[];
+};
+
+// Element types whose mrb_value is immediate, so an Array of them can be
+// filled in place without pushing or touching the GC arena.
+template<class T> struct PackedElement : std::false_type {};
+template<> struct PackedElement<int> : std::true_type {};
+template<> struct PackedElement<bool> : std::true_type {};
+#ifndef MRB_WORD_BOXING
+template<> struct PackedElement<unsigned int> : std::true_type {};
+template<> struct PackedElement<float> : std::true_type {};
+template<> struct PackedElement<double> : std::true_type {};
+#endif
+
+template<class T> struct TypeArray :public TypeArrayBase {
+    static int check(mrb_state* mrb, mrb_value v) {
+        if(!mrb_array_p(v)){
+            return 0;
+        }
+        const mrb_value* p = RARRAY_PTR(v);
+        for(mrb_int i = 0, n = RARRAY_LEN(v) ; i < n ; i++){
+            if(!Type<T>::check(mrb, p[i])){
+                return 0;
+            }
+        }
+        return 1;
+    }
+    static std::vector<T> get(mrb_state* mrb, mrb_value v) {
+        std::vector<T> vec;
+        mrb_int n = RARRAY_LEN(v);
+        vec.reserve(n);
+        for(mrb_int i = 0 ; i < n ; i++){
+            vec.push_back(Type<T>::get(mrb, RARRAY_PTR(v)[i]));
+        }
+        return vec;
+    }
+    static mrb_value ret(mrb_state* mrb, const std::vector<T>& vec) {
+        return ret(mrb, vec, PackedElement<T>());
+    }
+    static mrb_value ret(mrb_state* mrb, const std::vector<T>& vec, std::true_type) {
+        mrb_int n = (mrb_int)vec.size();
+        mrb_value ary = mrb_ary_new_capa(mrb, n);
+        mrb_ary_resize(mrb, ary, n);
+        mrb_value* p = const_cast<mrb_value*>(RARRAY_PTR(ary));
+        for(mrb_int i = 0 ; i < n ; i++){
+            p[i] = Type<T>::ret(mrb, vec[i]);
+        }
+        return ary;
+    }
+    static mrb_value ret(mrb_state* mrb, const std::vector<T>& vec, std::false_type) {
+        mrb_int n = (mrb_int)vec.size();
+        mrb_value ary = mrb_ary_new_capa(mrb, n);
+        int ai = mrb_gc_arena_save(mrb);
+        for(mrb_int i = 0 ; i < n ; i++){
+            mrb_ary_push(mrb, ary, Type<T>::ret(mrb, vec[i]));
+            mrb_gc_arena_restore(mrb, ai);
+        }
+        return ary;
+    }
+};
+
+template<class T> struct Type<std::vector<T> > :public TypeArray<T> {};
+template<class T> struct Type<const std::vector<T> > :public TypeArray<T> {};
+template<class T> struct Type<const std::vector<T>&> :public TypeArray<T> {};
+
+template<class T> struct TypeName<std::vector<T> >{
+    static const char* get(){
+        static const std::string name = std::string("Array of ") + type_name<T>();
+        return name.c_str();
+    }
+};
+
+// Element of a view, raising TypeError if it doesn't convert.
+template<class T>
+T view_element(mrb_state* mrb, mrb_value v){
+    if(!Type<T>::check(mrb, v)){
+        mrb_raisef(mrb, E_TYPE_ERROR, "can't convert %S into %S",
+                   mrb_str_new_cstr(mrb, mrb_obj_classname(mrb, v)),
+                   mrb_str_new_cstr(mrb, type_name<T>()));
+    }
+    return Type<T>::get(mrb, v);
+}
+
+// Reads an Array in place without copying it into a C++ container.
+// Elements are checked before the call and converted when accessed; the
+// length is read on each step, so Ruby code that shrinks the Array during
+// the loop ends it early. Valid only during the call.
+template<class T> class ArrayView{
+    mrb_state* mrb;
+    mrb_value ary;
+public:
+    class iterator{
+        mrb_state* mrb;
+        mrb_value ary;
+        mrb_int i;
+
+        bool at_end() const { return i >= RARRAY_LEN(ary); }
+    public:
+        iterator(mrb_state* mrb, mrb_value ary, mrb_int i) : mrb(mrb), ary(ary), i(i) {}
+        T operator*() const { return view_element<T>(mrb, mrb_ary_ref(mrb, ary, i)); }
+        iterator& operator++(){
+            i++;
+            return *this;
+        }
+        bool operator==(const iterator& it) const {
+            return at_end() || it.at_end() ? at_end() == it.at_end() : i == it.i;
+        }
+        bool operator!=(const iterator& it) const { return !(*this == it); }
+    };
+
+    ArrayView(mrb_state* mrb, mrb_value ary) : mrb(mrb), ary(ary) {}
+
+    mrb_value get_v() const { return ary; }
+    size_t size() const { return RARRAY_LEN(ary); }
+    bool empty() const { return size() == 0; }
+    T operator[](size_t i) const { return view_element<T>(mrb, mrb_ary_ref(mrb, ary, (mrb_int)i)); }
+
+    iterator begin() const { return iterator(mrb, ary, 0); }
+    iterator end() const { return iterator(mrb, ary, RARRAY_LEN(ary)); }
+};
+
+template<class T> struct Type<ArrayView<T> > :public TypeArrayBase {
+    static int check(mrb_state* mrb, mrb_value v) { return Type<std::vector<T> >::check(mrb, v); }
+    static ArrayView<T> get(mrb_state* mrb, mrb_value v) { return ArrayView<T>(mrb, v); }
+    static mrb_value ret(mrb_state*, const ArrayView<T>& a) { return a.get_v(); }
+};
+
+template<class T> struct TypeName<ArrayView<T> > :public TypeName<std::vector<T> > {};
+
+// Hash <-> std::map, std::unordered_map
+struct TypeHashBase{
+    static const char TYPE_NAME[];
+};
+
+// Walks the entries of a Hash in place, in hash table order.
+class HashIterator{
+    khash_t(ht)* h;
+    khiter_t k;
+
+    void skip(){
+        while(k != kh_end(h) && !kh_exist(h, k)){
+            k++;
+        }
+    }
+public:
+    HashIterator(mrb_value hash, bool end) : h(RHASH_TBL(hash)), k(0){
+        if(!h){
+            return;
+        }
+        if(end){
+            k = kh_end(h);
+        }
+        else{
+            skip();
+        }
+    }
+
+    mrb_value key() const { return kh_key(h, k); }
+    mrb_value value() const { return kh_value(h, k).v; }
+
+    HashIterator& operator++(){
+        k++;
+        skip();
+        return *this;
+    }
+    bool operator==(const HashIterator& i) const { return k == i.k; }
+    bool operator!=(const HashIterator& i) const { return k != i.k; }
+};
+
+inline size_t hash_size(mrb_value hash){
+    khash_t(ht)* h = RHASH_TBL(hash);
+    return h ? kh_size(h) : 0;
+}
+
+template<class K, class V> struct HashEntry {
+    static int check(mrb_state* mrb, mrb_value v) {
+        if(!mrb_hash_p(v)){
+            return 0;
+        }
+        for(HashIterator i(v, false), e(v, true) ; i != e ; ++i){
+            if(!Type<K>::check(mrb, i.key()) || !Type<V>::check(mrb, i.value())){
+                return 0;
+            }
+        }
+        return 1;
+    }
+    template<class M>
+    static mrb_value ret(mrb_state* mrb, const M& m) {
+        mrb_value hash = mrb_hash_new_capa(mrb, (int)m.size());
+        int ai = mrb_gc_arena_save(mrb);
+        for(typename M::const_iterator i = m.begin() ; i != m.end() ; ++i){
+            mrb_hash_set(mrb, hash, Type<K>::ret(mrb, i->first), Type<V>::ret(mrb, i->second));
+            mrb_gc_arena_restore(mrb, ai);
+        }
+        return hash;
+    }
+};
+
+template<class K, class V> struct TypeMap :public TypeHashBase {
+    static int check(mrb_state* mrb, mrb_value v) { return HashEntry<K, V>::check(mrb, v); }
+    static std::map<K, V> get(mrb_state* mrb, mrb_value v) {
+        std::map<K, V> m;
+        for(HashIterator i(v, false), e(v, true) ; i != e ; ++i){
+            m.insert(m.end(), std::make_pair(Type<K>::get(mrb, i.key()), Type<V>::get(mrb, i.value())));
+        }
+        return m;
+    }
+    static mrb_value ret(mrb_state* mrb, const std::map<K, V>& m) { return HashEntry<K, V>::ret(mrb, m); }
+};
+
+template<class K, class V> struct Type<std::map<K, V> > :public TypeMap<K, V> {};
+template<class K, class V> struct Type<const std::map<K, V> > :public TypeMap<K, V> {};
+template<class K, class V> struct Type<const std::map<K, V>&> :public TypeMap<K, V> {};
+
+template<class K, class V> struct TypeUnorderedMap :public TypeHashBase {
+    static int check(mrb_state* mrb, mrb_value v) { return HashEntry<K, V>::check(mrb, v); }
+    static std::unordered_map<K, V> get(mrb_state* mrb, mrb_value v) {
+        std::unordered_map<K, V> m;
+        m.reserve(hash_size(v));
+        for(HashIterator i(v, false), e(v, true) ; i != e ; ++i){
+            m.insert(std::make_pair(Type<K>::get(mrb, i.key()), Type<V>::get(mrb, i.value())));
+        }
+        return m;
+    }
+    static mrb_value ret(mrb_state* mrb, const std::unordered_map<K, V>& m) { return HashEntry<K, V>::ret(mrb, m); }
+};
+
+template<class K, class V> struct Type<std::unordered_map<K, V> > :public TypeUnorderedMap<K, V> {};
+template<class K, class V> struct Type<const std::unordered_map<K, V> > :public TypeUnorderedMap<K, V> {};
+template<class K, class V> struct Type<const std::unordered_map<K, V>&> :public TypeUnorderedMap<K, V> {};
+
+template<class K, class V> struct HashTypeName{
+    static const char* get(){
+        static const std::string name = std::string("Hash of ") + type_name<K>() + " => " + type_name<V>();
+        return name.c_str();
+    }
+};
+template<class K, class V> struct TypeName<std::map<K, V> > :public HashTypeName<K, V> {};
+template<class K, class V> struct TypeName<std::unordered_map<K, V> > :public HashTypeName<K, V> {};
+
+// Reads a Hash in place without copying it into a C++ container.
+// Keys and values are checked before the call and converted when accessed.
+// Valid only during the call.
+template<class K, class V> class HashView{
+    mrb_state* mrb;
+    mrb_value hash;
+public:
+    class iterator{
+        mrb_state* mrb;
+        HashIterator i;
+    public:
+        iterator(mrb_state* mrb, const HashIterator& i) : mrb(mrb), i(i) {}
+        std::pair<K, V> operator*() const {
+            return std::pair<K, V>(view_element<K>(mrb, i.key()), view_element<V>(mrb, i.value()));
+        }
+        iterator& operator++(){
+            ++i;
+            return *this;
+        }
+        bool operator==(const iterator& it) const { return i == it.i; }
+        bool operator!=(const iterator& it) const { return i != it.i; }
+    };
+
+    HashView(mrb_state* mrb, mrb_value hash) : mrb(mrb), hash(hash) {}
+
+    mrb_value get_v() const { return hash; }
+    size_t size() const { return hash_size(hash); }
+    bool empty() const { return size() == 0; }
+
+    iterator begin() const { return iterator(mrb, HashIterator(hash, false)); }
+    iterator end() const { return iterator(mrb, HashIterator(hash, true)); }
+
+    // Looks the key up in the Hash itself.
+    bool has_key(const K& key) const {
+        MrubyArenaStore store(mrb);
+        return !mrb_undef_p(mrb_hash_fetch(mrb, hash, Type<K>::ret(mrb, key), mrb_undef_value()));
+    }
+    V get(const K& key, const V& def = V()) const {
+        MrubyArenaStore store(mrb);
+        mrb_value v = mrb_hash_fetch(mrb, hash, Type<K>::ret(mrb, key), mrb_undef_value());
+        return mrb_undef_p(v) ? def : view_element<V>(mrb, v);
+    }
+};
+
+template<class K, class V> struct Type<HashView<K, V> > :public TypeHashBase {
+    static int check(mrb_state* mrb, mrb_value v) { return HashEntry<K, V>::check(mrb, v); }
+    static HashView<K, V> get(mrb_state* mrb, mrb_value v) { return HashView<K, V>(mrb, v); }
+    static mrb_value ret(mrb_state*, const HashView<K, V>& h) { return h.get_v(); }
+};
+
+template<class K, class V> struct TypeName<HashView<K, V> > :public HashTypeName<K, V> {};
+
+// View which holds a MrubyRef to its collection.
+template<class View> class PinnedView :public View{
+    MrubyRef ref;
+public:
+    explicit PinnedView(const MrubyRef& ref) : View(ref.get_mrb(), ref.get_v()), ref(ref) {}
+};
+
+template<class T> PinnedView<ArrayView<T> > MrubyRef::array_view() const{
+    if(!data || !Type<std::vector<T> >::check(get_mrb(), get_v())){
+        throw std::runtime_error(std::string("can't convert ") + (data ? mrb_obj_classname(get_mrb(), get_v()) : "empty reference") +
+                                 " into " + type_name<std::vector<T> >());
+    }
+    return PinnedView<ArrayView<T> >(*this);
+}
+
+template<class K, class V> PinnedView<HashView<K, V> > MrubyRef::hash_view() const{
+    if(!data || !HashEntry<K, V>::check(get_mrb(), get_v())){
+        throw std::runtime_error(std::string("can't convert ") + (data ? mrb_obj_classname(get_mrb(), get_v()) : "empty reference") +
+                                 " into " + type_name<std::map<K, V> >());
+    }
+    return PinnedView<HashView<K, V> >(*this);
+}
 
-#include "mrubybind_types_generated.h"
 
 //===========================================================================
 // Binder
@@ -524,59 +2040,56 @@ struct CustomClassBinder {
   //static mrb_value call(mrb_state* mrb, void* p, mrb_value* args, int narg) = 0;
 };
 
+// Allocates an instance of the class bound to T, without calling initialize.
+template<class T>
+RData* new_class_data(mrb_state* mrb) {
+    MrubyBindStatus::Data* d = MrubyBindStatus::lookup(mrb);
+    RClass* cls = d ? d->get_class(ClassId<T>::get()) : NULL;
+    if(!cls){
+        mrb_raise(mrb, E_TYPE_ERROR, "C++ class is not bound");
+    }
+    return mrb_data_object_alloc(mrb, cls, NULL, &ClassBinder<T>::type_info);
+}
+
 // Other Class
 struct TypeClassBase{
     static const char TYPE_NAME[];
 };
 
 template<class T> struct Type<T&> :public TypeClassBase {
-    static std::string class_name;
     static int check(mrb_state* mrb, mrb_value v) {
-        return mrb_type(v) == MRB_TT_DATA &&
-            MrubyBindStatus::search(mrb)->is_convertable(mrb_obj_classname(mrb, v), class_name);
+        MrubyBindStatus::Data* d = MrubyBindStatus::lookup(mrb);
+        return mrb_type(v) == MRB_TT_DATA && d &&
+            d->is_convertable(mrb_obj_class(mrb, v), ClassId<T>::get());
     }
     static T& get(mrb_state* mrb, mrb_value v) {
         (void)mrb; return *(T*)DATA_PTR(v);
     }
-    static mrb_value ret(mrb_state* mrb, T t) {
-        RClass* cls;
-        mrb_value v;
-        cls = mrb_class_get(mrb, class_name.c_str());
-        v = mrb_class_new_instance(mrb, 0, NULL, cls);
-        DATA_TYPE(v) = &ClassBinder<T>::type_info;
-        T* nt = new T();
-        *nt = t;
-        DATA_PTR(v) = nt;
-        return v;
+    template<class U>
+    static mrb_value ret(mrb_state* mrb, U&& t) {
+        RData* data = new_class_data<T>(mrb);
+        data->data = new T(std::forward<U>(t));
+        return mrb_obj_value(data);
     }
 };
 
-template<class T> std::string Type<T&>::class_name = "";
-
 template<class T> struct Type :public TypeClassBase {
-    static std::string class_name;
     static int check(mrb_state* mrb, mrb_value v) {
-        return mrb_type(v) == MRB_TT_DATA &&
-            MrubyBindStatus::search(mrb)->is_convertable(mrb_obj_classname(mrb, v), class_name);
+        MrubyBindStatus::Data* d = MrubyBindStatus::lookup(mrb);
+        return mrb_type(v) == MRB_TT_DATA && d &&
+            d->is_convertable(mrb_obj_class(mrb, v), ClassId<T>::get());
     }
     static T get(mrb_state* mrb, mrb_value v) {
             (void)mrb; return *(T*)DATA_PTR(v);
         }
-    static mrb_value ret(mrb_state* mrb, T t) {
-        RClass* cls;
-        mrb_value v;
-        cls = mrb_class_get(mrb, class_name.c_str());
-        v = mrb_class_new_instance(mrb, 0, NULL, cls);
-        DATA_TYPE(v) = &ClassBinder<T>::type_info;
-        T* nt = new T();
-        *nt = t;
-        DATA_PTR(v) = nt;
-        return v;
+    template<class U>
+    static mrb_value ret(mrb_state* mrb, U&& t) {
+        RData* data = new_class_data<T>(mrb);
+        data->data = new T(std::forward<U>(t));
+        return mrb_obj_value(data);
     }
 };
 
-template<class T> std::string Type<T>::class_name = "";
-
 //
 mrb_value raise(mrb_state *mrb, int parameter_index,
                 const char* required_type_name, mrb_value value);
@@ -110,35 +110,35 @@ void UseModuleTest(mrb_state* mrb) {
 //
 
 
-std::string call_block(mrubybind::FuncPtr<void()> f) {
+std::string call_block(mrubybind::FuncRef<void()> f) {
   if(f)
   {
       cout << "pre f\n";
-      f.func()();
+      f();
       cout << "post f\n";
   }
   return "call_block called\n";
 }
 
-std::string call_block_a1(mrubybind::FuncPtr<void(int a0)> f) {
+std::string call_block_a1(mrubybind::FuncRef<void(int a0)> f) {
   if(f)
   {
-      f.func()(23);
+      f(23);
   }
   return "call_block_a1 called\n";
 }
 
-std::string call_block_a2(mrubybind::FuncPtr<void(int a0, std::string a1)> f) {
+std::string call_block_a2(mrubybind::FuncRef<void(int a0, std::string a1)> f) {
   if(f)
   {
-      f.func()(23, "string");
+      f(23, "string");
   }
   return "call_block_a2 called\n";
 }
 
-std::string call_block_a1_int(mrubybind::FuncPtr<int(int a0)> f) {
+std::string call_block_a1_int(mrubybind::FuncRef<int(int a0)> f) {
   std::stringstream s;
-  s << "call_block_a1_int return this ->" << f.func()(23);
+  s << "call_block_a1_int return this ->" << f(23);
   return  s.str();
 }
 
@@ -166,14 +166,14 @@ public:
         a = 5;
     }
 
-    int func_test(mrubybind::FuncPtr<void(int a0)> f)
+    int func_test(mrubybind::FuncRef<void(int a0)> f)
     {
-        f.func()(a);
+        f(a);
         return a;
     }
 
-    std::string func_a2_string(mrubybind::FuncPtr<std::string(int a0, std::string a1)> f) {
-      return f.func()(48, "str");
+    std::string func_a2_string(mrubybind::FuncRef<std::string(int a0, std::string a1)> f) {
+      return f(48, "str");
     }
 };
 
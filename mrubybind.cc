@@ -5,7 +5,15 @@
 #include "mruby/proc.h"
 #include "mruby/string.h"
 #include "mruby/variable.h"
+#include <cstdio>
 #include <iostream>
+#include <sstream>
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
 
 namespace mrubybind {
 
@@ -14,21 +22,39 @@ namespace mrubybind {
 
 const char Type<int>::TYPE_NAME[] = "Fixnum";
 const char Type<unsigned int>::TYPE_NAME[] = "Fixnum";
+const char Type<signed char>::TYPE_NAME[] = "Fixnum";
+const char Type<unsigned char>::TYPE_NAME[] = "Fixnum";
+const char Type<short>::TYPE_NAME[] = "Fixnum";
+const char Type<unsigned short>::TYPE_NAME[] = "Fixnum";
+const char Type<long>::TYPE_NAME[] = "Fixnum";
+const char Type<unsigned long>::TYPE_NAME[] = "Fixnum";
+const char Type<long long>::TYPE_NAME[] = "Fixnum";
+const char Type<unsigned long long>::TYPE_NAME[] = "Fixnum";
 const char Type<float>::TYPE_NAME[] = "Float";
 const char Type<double>::TYPE_NAME[] = "Float";
 const char Type<const char*>::TYPE_NAME[] = "String";
 const char Type<std::string>::TYPE_NAME[] = "String";
 const char Type<const std::string>::TYPE_NAME[] = "String";
 const char Type<const std::string&>::TYPE_NAME[] = "String";
+const char Type<ByteSpan>::TYPE_NAME[] = "String";
 const char Type<bool>::TYPE_NAME[] = "Bool";
 const char Type<void*>::TYPE_NAME[] = "Voidp";
 const char Type<MrubyRef>::TYPE_NAME[] = "MrubyRef";
+const char Type<MrubyValueView>::TYPE_NAME[] = "MrubyValueView";
 const char TypeFuncBase::TYPE_NAME[] = "Func";
 const char TypeClassBase::TYPE_NAME[] = "CppClass";
+const char TypeArrayBase::TYPE_NAME[] = "Array";
+const char TypeHashBase::TYPE_NAME[] = "Hash";
 
 const char* untouchable_table = "__ untouchable table __";
 const char* untouchable_object = "__ untouchable object __";
 const char* untouchable_last_exception = "__ untouchable last exception __";
+const char* untouchable_protect_class = "__ untouchable protect class __";
+
+size_t new_class_id() {
+  static std::atomic<size_t> last_id(0);
+  return last_id++;
+}
 
 mrb_value raise(mrb_state *mrb, int parameter_index,
                 const char* required_type_name, mrb_value value) {
@@ -48,6 +74,63 @@ mrb_value raisenarg(mrb_state *mrb, mrb_value func_name, int narg, int nparam) {
   return mrb_nil_value();
 }
 
+// Function and data given to protect().
+struct ProtectedCall {
+  void (*f)(mrb_state*, void*);
+  void* data;
+};
+
+// Body of protect(), a cfunc method called with mrb_funcall_argv(), which
+// then sets up the jump buffer and pops the frames left by a raise.
+static mrb_value protected_call(mrb_state* mrb, mrb_value /*self*/) {
+  mrb_value call;
+  mrb_get_args(mrb, "o", &call);
+  if (mrb_cptr_p(call)) {
+    ProtectedCall* c = static_cast<ProtectedCall*>(mrb_cptr(call));
+    c->f(mrb, c->data);
+  }
+  return mrb_nil_value();
+}
+
+bool protect(mrb_state* mrb, void (*f)(mrb_state*, void*), void* data, std::string& error) {
+  MrubyBindStatus::Data* d = MrubyBindStatus::lookup(mrb);
+  if (!d) {
+    error = "mrubybind isn't set up in this mrb_state.";
+    return false;
+  }
+  // A method, not a Proc: Proc#call on a cfunc proc isn't safe from
+  // mrb_funcall() in mruby 1.x. The class has no constant, so scripts
+  // can't reach it.
+  if (!d->protect_class) {
+    d->protect_class = mrb_class_new(mrb, mrb->object_class);
+    mrb_define_class_method(mrb, d->protect_class, "call", protected_call, MRB_ARGS_REQ(1));
+    mrb_obj_iv_set(mrb, (RObject*)mrb_define_module(mrb, "MrubyBind"),
+                   mrb_intern_cstr(mrb, untouchable_protect_class), mrb_obj_value(d->protect_class));
+  }
+  ProtectedCall c = {f, data};
+  mrb_value arg = mrb_cptr_value(mrb, &c);
+  // Without a jump buffer, mrb_funcall_argv() catches the exception itself
+  // and returns, even when called from inside the VM. An exception already
+  // pending belongs to the caller: it's put back whatever f does.
+  struct mrb_jmpbuf* jmp = mrb->jmp;
+  struct RObject* pending = mrb->exc;
+  mrb->jmp = NULL;
+  mrb->exc = NULL;
+  mrb_funcall_argv(mrb, mrb_obj_value(d->protect_class), mrb_intern_cstr(mrb, "call"), 1, &arg);
+  bool ok = !mrb->exc;
+  if (!ok) {
+    mrb_value exc = mrb_obj_value(mrb->exc);
+    mrb_value mesg = mrb_iv_get(mrb, exc, mrb_intern_cstr(mrb, "mesg"));
+    error = mrb_obj_classname(mrb, exc);
+    if (mrb_string_p(mesg)) {
+      error += ": ";
+      error.append(RSTRING_PTR(mesg), RSTRING_LEN(mesg));
+    }
+  }
+  mrb->exc = pending;
+  mrb->jmp = jmp;
+  return ok;
+}
 
 void
 MrubyBind::mrb_define_class_method_raw(mrb_state *mrb, struct RClass *c, mrb_sym mid, struct RProc *p)
@@ -200,14 +283,199 @@ void MrubyBind::BindInstanceMethod(const char* module_name,
   mrb_define_method_raw(mrb_, klass, method_name_s, proc);
 }
 
+// Scripts kept by load_string() before the cache is cleared.
+static const size_t script_cache_limit = 1024;
+
+// FNV-1a hash of a script's text.
+static uint64_t script_hash(const std::string& code)
+{
+    uint64_t h = 14695981039346656037ULL;
+    for(size_t i = 0 ; i < code.size() ; i++){
+        h ^= (unsigned char)code[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+static std::string script_path(const std::string& dir, uint64_t hash, size_t size)
+{
+    char name[64];
+    snprintf(name, sizeof(name), "/%016llx-%llx.mrb",
+             (unsigned long long)hash, (unsigned long long)size);
+    return dir + name;
+}
+
+// Compiles code without running it. Returns NULL and sets mrb->exc on a
+// syntax error.
+static RProc* compile_script(mrb_state* mrb, const std::string& code, const char* filename = NULL)
+{
+    mrbc_context* c = mrbc_context_new(mrb);
+    c->no_exec = TRUE;
+    if(filename){
+        mrbc_filename(mrb, c, filename);
+    }
+    mrb_value v = mrb_load_nstring_cxt(mrb, code.c_str(), (int)code.size(), c);
+    mrbc_context_free(mrb, c);
+    if(mrb->exc || mrb_type(v) != MRB_TT_PROC){
+        return NULL;
+    }
+    return mrb_proc_ptr(v);
+}
+
+// Runs compiled code at the top level, as mrb_load_string() would.
+static mrb_value run_script(mrb_state* mrb, RProc* proc)
+{
+    proc->target_class = mrb->object_class;
+    return mrb_top_run(mrb, proc, mrb_top_self(mrb), 0);
+}
+
+// Reads a script written by store_script(), or returns NULL when the file
+// was written for another text. The irep is read from the file, not from a
+// buffer: mrb_read_irep() would leave the symbols and strings pointing
+// into the buffer.
+static RProc* load_script(mrb_state* mrb, const std::string& path, const std::string& code)
+{
+    FILE* fp = fopen(path.c_str(), "rb");
+    if(!fp){
+        return NULL;
+    }
+    // The text follows the irep.
+    rite_binary_header header;
+    std::string text(code.size() + 1, '\0');
+    bool same = fread(&header, sizeof(header), 1, fp) == 1 &&
+        fseek(fp, (long)bin_to_uint32(header.binary_size), SEEK_SET) == 0 &&
+        fread(&text[0], 1, text.size(), fp) == code.size() &&
+        text.compare(0, code.size(), code) == 0;
+    mrb_irep* irep = NULL;
+    if(same){
+        rewind(fp);
+        irep = mrb_read_irep_file(mrb, fp);
+    }
+    fclose(fp);
+    if(!irep){
+        return NULL;
+    }
+    RProc* proc = mrb_proc_new(mrb, irep);
+    mrb_irep_decref(mrb, irep);
+    return proc;
+}
+
+// Writes a script with its line numbers, followed by its text. Renamed
+// into place, so that a reader never sees a partial file.
+static void store_script(mrb_state* mrb, RProc* proc, const std::string& path, const std::string& code)
+{
+    uint8_t* bin = NULL;
+    size_t size = 0;
+    if(mrb_dump_irep(mrb, proc->body.irep, DUMP_DEBUG_INFO, &bin, &size) != MRB_DUMP_OK){
+        return;
+    }
+    // Named for this process, thread and call, so that writers of the same
+    // script never share a temporary file; rename() replaces it at once.
+    static std::atomic<size_t> tmp_count(0);
+    std::ostringstream tmp_name;
+    tmp_name << path << "." << getpid() << "." << std::this_thread::get_id() << "." << tmp_count++ << ".tmp";
+    std::string tmp = tmp_name.str();
+    FILE* fp = fopen(tmp.c_str(), "wb");
+    if(fp){
+        bool ok = fwrite(bin, 1, size, fp) == size &&
+            fwrite(code.data(), 1, code.size(), fp) == code.size();
+        if(fclose(fp) != 0 || !ok || rename(tmp.c_str(), path.c_str()) != 0){
+            remove(tmp.c_str());
+        }
+    }
+    mrb_free(mrb, bin);
+}
+
+// Returns the compiled code, from the cache if it was compiled before.
+static RProc* cached_script(mrb_state* mrb, const std::string& code)
+{
+    MrubyBindStatus::Data* d = MrubyBindStatus::lookup(mrb);
+    if(!d){
+        return compile_script(mrb, code);
+    }
+    uint64_t hash = script_hash(code);
+    MrubyBindStatus::ScriptCache::iterator it = d->script_cache.find(hash);
+    if(it != d->script_cache.end() && it->second.code == code){
+        d->script_cache_hits++;
+        return mrb_proc_ptr(it->second.proc);
+    }
+    d->script_cache_misses++;
+    RProc* proc = NULL;
+    std::string path;
+    if(!d->script_cache_dir.empty()){
+        path = script_path(d->script_cache_dir, hash, code.size());
+        proc = load_script(mrb, path, code);
+        if(proc){
+            d->script_cache_loaded++;
+        }
+    }
+    if(!proc){
+        proc = compile_script(mrb, code);
+        if(!proc){
+            return NULL;
+        }
+        if(!path.empty()){
+            store_script(mrb, proc, path, code);
+        }
+    }
+    // A different script with the same hash is replaced.
+    if(it != d->script_cache.end()){
+        d->unpin(it->second.proc);
+        d->script_cache.erase(it);
+    }
+    // Generated scripts would grow it without limit.
+    if(d->script_cache.size() >= script_cache_limit){
+        clear_script_cache(mrb);
+    }
+    MrubyBindStatus::Script& script = d->script_cache[hash];
+    script.code = code;
+    script.proc = mrb_obj_value(proc);
+    d->pin(script.proc);
+    return proc;
+}
+
+ScriptCacheStats get_script_cache_stats(mrb_state* mrb)
+{
+    ScriptCacheStats stats = {0, 0, 0, 0};
+    if(MrubyBindStatus::Data* d = MrubyBindStatus::lookup(mrb)){
+        stats.hits = d->script_cache_hits;
+        stats.misses = d->script_cache_misses;
+        stats.loaded = d->script_cache_loaded;
+        stats.size = d->script_cache.size();
+    }
+    return stats;
+}
+
+void set_script_cache_dir(mrb_state* mrb, const std::string& dir)
+{
+    if(MrubyBindStatus::Data* d = MrubyBindStatus::lookup(mrb)){
+        d->script_cache_dir = dir;
+    }
+}
+
+void clear_script_cache(mrb_state* mrb)
+{
+    if(MrubyBindStatus::Data* d = MrubyBindStatus::lookup(mrb)){
+        for(MrubyBindStatus::ScriptCache::iterator it = d->script_cache.begin() ;
+            it != d->script_cache.end() ; ++it){
+            d->unpin(it->second.proc);
+        }
+        d->script_cache.clear();
+    }
+}
+
 MrubyRef load_string(mrb_state* mrb, std::string code)
 {
     mrubybind::MrubyArenaStore mas(mrb);
 
     RClass* mrubybind = mrb_define_module(mrb, "MrubyBind");
     mrb->exc = NULL;
-    mrb_value r = mrb_load_string(mrb,
-                    code.c_str());
+    MrubyBindStatus::run_posted(mrb);
+    mrb_value r = mrb_nil_value();
+    RProc* proc = cached_script(mrb, code);
+    if(proc){
+        r = run_script(mrb, proc);
+    }
     if(mrb->exc){
         mrb_obj_iv_set(mrb, (RObject*)mrubybind,
                        mrb_intern_cstr(mrb, untouchable_last_exception), mrb_obj_value(mrb->exc));
@@ -221,128 +489,208 @@ MrubyRef load_string(mrb_state* mrb, std::string code)
     return MrubyRef(mrb, r);
 }
 
-MrubyRef::MrubyRef(){
+size_t run_pending(mrb_state* mrb)
+{
+    MrubyBindStatus::Data* d = MrubyBindStatus::lookup(mrb);
+    return d ? d->run_pending() : 0;
+}
 
+void set_vm_thread(mrb_state* mrb)
+{
+    if(MrubyBindStatus::Data* d = MrubyBindStatus::lookup(mrb)){
+        d->owner = std::this_thread::get_id();
+    }
 }
 
 MrubyRef::MrubyRef(mrb_state* mrb, const mrb_value& v){
-    this->mrb = mrb;
-    mrb_value* p = new mrb_value();
-    *p = v;
-    this->v = std::shared_ptr<mrb_value>(p, set_avoid_gc<mrb_value>(mrb, v));
+    data = MrubyBindStatus::lookup(mrb);
+    if(!data){
+        throw std::runtime_error("mrubybind isn't set up in this mrb_state.");
+    }
+    handle = data->new_handle(v);
 }
 
-MrubyRef::~MrubyRef(){
+MrubyRef::MrubyRef(const MrubyValueView& v) : MrubyRef(v.get_mrb(), v.get_v()){
 
 }
 
 bool MrubyRef::is_living() const{
-    return MrubyBindStatus::is_living(mrb);
+    return data && data->get_mrb();
 }
 
-mrb_state* MrubyRef::get_mrb() const{
-    return this->mrb;
-}
-
-mrb_value MrubyRef::get_v() const{
-    if(v.get()){
-        return *(this->v.get());
-    }
-    return mrb_nil_value();
+MrubyValueView MrubyRef::view() const{
+    return MrubyValueView(get_mrb(), get_v());
 }
 
 bool MrubyRef::empty() const{
-    if(!v.get()){
-        return true;
-    }
-    return false;
+    return !data;
 }
 
 bool MrubyRef::test() const{
-    if(v.get()){
-        mrb_value v = *(this->v.get());
-        return mrb_test(v);
-    }
-    return false;
+    return view().test();
 }
 
 bool MrubyRef::obj_equal(const MrubyRef& r) const{
-    if(!empty() && !r.empty()){
-        return mrb_obj_equal(mrb, get_v(), r.get_v());
-    }
-    else{
-        return empty() == r.empty();
-    }
+    return view().obj_equal(r.view());
 }
 
 std::string MrubyRef::to_s() const{
-    if(v.get()){
-        MrubyArenaStore mas(mrb);
-        mrb_value v = *(this->v.get());
-        if(mrb_string_p(v)){
-            return std::string(RSTRING_PTR(v), RSTRING_LEN(v));
-        }
-        else{
-            v = mrb_funcall(mrb, v, "to_s", 0);
-            return std::string(RSTRING_PTR(v), RSTRING_LEN(v));
-        }
-    }
-    else{
-        return "";
-    }
+    return view().to_s();
 }
 
 int MrubyRef::to_i() const{
-    if(v.get()){
-        mrb_value v = *(this->v.get());
-        if(mrb_fixnum_p(v)){
-            return mrb_fixnum(v);
-        }
-        else{
-            v = mrb_funcall(mrb, v, "to_i", 0);
-            return mrb_fixnum(v);
-        }
-    }
-    else{
-        return 0;
-    }
+    return view().to_i();
 }
 
 float MrubyRef::to_float() const{
-    if(v.get()){
-        mrb_value v = *(this->v.get());
-        if(mrb_float_p(v)){
-            return mrb_float(v);
-        }
-        else{
-            v = mrb_funcall(mrb, v, "to_f", 0);
-            return mrb_float(v);
-        }
-    }
-    else{
-        return 0.0f;
-    }
+    return view().to_float();
 }
 
 double MrubyRef::to_double() const{
-    if(v.get()){
-        mrb_value v = *(this->v.get());
-        if(mrb_float_p(v)){
-            return mrb_float(v);
-        }
-        else{
-            v = mrb_funcall(mrb, v, "to_f", 0);
-            return (double)mrb_float(v);
-        }
+    return view().to_double();
+}
+
+MrubyRef MrubyRef::call(const std::string& name){
+    return view().call(name);
+}
+
+bool MrubyValueView::empty() const{
+    return !mrb;
+}
+
+bool MrubyValueView::test() const{
+    return mrb && mrb_test(v);
+}
+
+bool MrubyValueView::obj_equal(const MrubyValueView& r) const{
+    if(!empty() && !r.empty()){
+        return mrb_obj_equal(mrb, v, r.v);
     }
     else{
-        return 0.0;
+        return empty() == r.empty();
     }
 }
 
-MrubyRef MrubyRef::call(std::string name){
+std::string MrubyValueView::to_s() const{
+    std::string s;
+    try_as(s);
+    return s;
+}
+
+int MrubyValueView::to_i() const{
+    // Read as mrb_int and cut to int, so that a Fixnum out of int range is
+    // truncated as it always was, not turned into 0.
+    mrb_int i = 0;
+    try_as(i);
+    return (int)i;
+}
+
+float MrubyValueView::to_float() const{
+    float f = 0.0f;
+    try_as(f);
+    return f;
+}
+
+double MrubyValueView::to_double() const{
+    double d = 0.0;
+    try_as(d);
+    return d;
+}
+
+MrubyRef MrubyValueView::call(const std::string& name) const{
     MrubyArenaStore mas(mrb);
-    return MrubyRef(mrb, mrb_funcall(mrb, *(this->v.get()), name.c_str(), 0));
+    return MrubyRef(mrb, mrb_funcall(mrb, v, name.c_str(), 0));
+}
+
+MrubyMethod::MrubyMethod() : sym(0), klass(NULL), owner(NULL){
+
+}
+
+MrubyMethod::MrubyMethod(const MrubyRef& self, const std::string& name) :
+    self(self), klass(NULL), owner(NULL){
+    sym = mrb_intern(self.get_mrb(), name.c_str(), name.size());
+}
+
+const MrubyRef& MrubyMethod::get_self() const{
+    return self;
+}
+
+mrb_sym MrubyMethod::get_sym() const{
+    return sym;
+}
+
+void MrubyMethod::invalidate(){
+    klass = NULL;
+    owner = NULL;
+    proc = MrubyRef();
+}
+
+mrb_value MrubyMethod::invoke(mrb_int argc, const mrb_value* argv){
+    mrb_state* mrb = self.get_mrb();
+    mrb_value v = self.get_v();
+    RClass* c = mrb_class(mrb, v);
+    if(c != klass){
+        klass = c;
+        owner = c;
+        RProc* p = mrb_method_search_vm(mrb, &owner, sym);
+        proc = p ? MrubyRef(mrb, mrb_obj_value(p)) : MrubyRef();
+    }
+    RProc* p = proc.empty() ? NULL : mrb_proc_ptr(proc.get_v());
+    if(!p || (!mrb->jmp && MRB_PROC_CFUNC_P(p))){
+        // Leaves method_missing and NoMethodError to mruby. Outside the VM
+        // nothing would catch what a C method raises, and
+        // mrb_yield_with_class() sets up no handler; mrb_funcall_argv()
+        // does, and leaves the exception in mrb->exc.
+        return mrb_funcall_argv(mrb, v, sym, argc, argv);
+    }
+    // Runs the method as mrb_funcall would after its lookup. The new frame
+    // takes its name from the current one, so lend it ours. A raise inside
+    // the VM unwinds the current frame too; at the top level the VM stops
+    // with the exception in mrb->exc, and returns here. The frames may have
+    // moved when the method ran, so the current one is found again.
+    ptrdiff_t cioff = mrb->c->ci - mrb->c->cibase;
+    mrb_sym mid = mrb->c->ci->mid;
+    mrb->c->ci->mid = sym;
+    mrb_value r = mrb_yield_with_class(mrb, proc.get_v(), argc, argv, v, owner);
+    mrb->c->cibase[cioff].mid = mid;
+    return r;
+}
+
+MrubyScript::MrubyScript(){
+
+}
+
+MrubyScript::MrubyScript(mrb_state* mrb, const std::string& code, const std::string& filename) :
+    filename(filename){
+    mrubybind::MrubyArenaStore mas(mrb);
+    mrb->exc = NULL;
+    RProc* p = compile_script(mrb, code, filename.empty() ? NULL : filename.c_str());
+    if(p){
+        proc = MrubyRef(mrb, mrb_obj_value(p));
+    }
+}
+
+bool MrubyScript::empty() const{
+    return proc.empty();
+}
+
+const std::string& MrubyScript::get_filename() const{
+    return filename;
+}
+
+MrubyRef MrubyScript::run(){
+    mrb_state* mrb = proc.get_mrb();
+    if(!mrb){
+        return MrubyRef();
+    }
+    mrubybind::MrubyArenaStore mas(mrb);
+    mrb->exc = NULL;
+    MrubyBindStatus::run_posted(mrb);
+    mrb_value r = run_script(mrb, mrb_proc_ptr(proc.get_v()));
+    if(mrb->exc){
+        r = mrb_nil_value();
+    }
+    return MrubyRef(mrb, r);
 }
 
 
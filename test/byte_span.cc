@@ -0,0 +1,58 @@
+#include <mruby.h>
+#include <mruby/compile.h>
+#include "mrubybind.h"
+
+#include <iostream>
+using namespace std;
+
+int count_fields(mrubybind::ByteSpan line)
+{
+    int n = 1;
+    for(unsigned char c : line){
+        if(c == ','){
+            n++;
+        }
+    }
+    return n;
+}
+
+mrubybind::ByteSpan first_field(mrubybind::ByteSpan line)
+{
+    size_t n = 0;
+    while(n < line.size && line[n] != ','){
+        n++;
+    }
+    return mrubybind::ByteSpan(line.data, n);
+}
+
+// The std::string_view overload is in string_view.cc.
+int line_length(const std::string& line)
+{
+    return (int)line.size();
+}
+
+int main() {
+  mrb_state* mrb = mrb_open();
+
+  {
+    mrubybind::MrubyBind b(mrb);
+    b.bind("count_fields", count_fields);
+    b.bind("first_field", first_field);
+    b.bind("line_length", line_length);
+  }
+
+  int result_code = EXIT_SUCCESS;
+  mrb_load_string(mrb,
+                  "line = \"abc,de,\\0,fgh\"\n"
+                  "puts count_fields(line)\n"
+                  "puts first_field(line)\n"
+                  "puts line_length(line)\n"
+                  );
+  if (mrb->exc) {
+    mrb_p(mrb, mrb_obj_value(mrb->exc));
+    result_code = EXIT_FAILURE;
+  }
+
+  mrb_close(mrb);
+  return result_code;
+}
@@ -0,0 +1,88 @@
+#include <mruby.h>
+#include <mruby/compile.h>
+#include "mrubybind.h"
+
+#include <iostream>
+#include <iterator>
+using namespace std;
+
+// Results written into a preallocated vector.
+std::vector<int> scores(mrubybind::FuncRef<int(int a0, std::string a1)> f)
+{
+    std::vector<std::tuple<int, std::string> > records;
+    records.push_back(std::make_tuple(1, "a"));
+    records.push_back(std::make_tuple(2, "bb"));
+    records.push_back(std::make_tuple(3, "ccc"));
+    std::vector<int> r(records.size());
+    f.call_each(records.begin(), records.end(), r.begin());
+    return r;
+}
+
+// A column of values for a block taking one argument.
+int sum_squares(mrubybind::FuncRef<int(int a0)> f)
+{
+    std::vector<int> column;
+    for(int i = 1 ; i <= 3 ; i++){
+        column.push_back(i);
+    }
+    std::vector<int> r;
+    f.call_each(column.begin(), column.end(), std::back_inserter(r));
+    int s = 0;
+    for(size_t i = 0 ; i < r.size() ; i++){
+        s += r[i];
+    }
+    return s;
+}
+
+void each_pair(mrubybind::FuncRef<void(std::string a0, int a1)> f)
+{
+    std::map<std::string, int> m;
+    m["x"] = 1;
+    m["y"] = 2;
+    f.call_each(m.begin(), m.end());
+}
+
+mrubybind::FuncPtr<void(std::string a0)> kept;
+
+void keep(mrubybind::FuncPtr<void(std::string a0)> f)
+{
+    kept = f;
+}
+
+void each_kept()
+{
+    std::vector<std::string> names;
+    names.push_back("a");
+    names.push_back("b");
+    kept.call_each(names.begin(), names.end());
+}
+
+int main() {
+  mrb_state* mrb = mrb_open();
+
+  {
+    mrubybind::MrubyBind b(mrb);
+    b.bind("scores", scores);
+    b.bind("sum_squares", sum_squares);
+    b.bind("each_pair", each_pair);
+    b.bind("keep", keep);
+    b.bind("each_kept", each_kept);
+  }
+
+  int result_code = EXIT_SUCCESS;
+  mrb_load_string(mrb,
+                  "p scores { |n, s| n * s.size }\n"
+                  "puts sum_squares { |a0| a0 * a0 }\n"
+                  "each_pair { |k, v| puts \"#{k}=#{v}\" }\n"
+                  "keep { |s| puts s }\n"
+                  "each_kept\n"
+                  );
+  if (mrb->exc) {
+    mrb_p(mrb, mrb_obj_value(mrb->exc));
+    result_code = EXIT_FAILURE;
+  }
+  kept.reset();
+
+  mrb_close(mrb);
+  return result_code;
+}
@@ -78,6 +78,28 @@ int main() {
     result_code = EXIT_FAILURE;
   }
 
+  mrb_close(mrb);
+
+  // add_convertable() given at setup time, before either class is bound.
+  mrb = mrb_open();
+  {
+    mrubybind::MrubyBind b(mrb);
+    b.add_convertable("TA", "TB");
+    b.bind_class<std::shared_ptr<TA> >("TA");
+    b.bind_class<std::shared_ptr<TB> >("TB");
+    b.bind_static_method("TA", "create", create_a);
+    b.bind_static_method("TB", "create", create_b);
+    b.bind_static_method("TA", "get_num", get_num_a);
+  }
+  mrb_load_string(mrb,
+                  "b = TB.create\n"
+                  "puts \"TA -> b = #{TA.get_num b}\"\n"
+                  );
+  if (mrb->exc) {
+    mrb_p(mrb, mrb_obj_value(mrb->exc));
+    result_code = EXIT_FAILURE;
+  }
+
   mrb_close(mrb);
   return result_code;
 }
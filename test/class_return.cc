@@ -0,0 +1,65 @@
+#include <mruby.h>
+#include <mruby/compile.h>
+#include "mrubybind.h"
+
+#include <iostream>
+using namespace std;
+
+// No default constructor; counts copies and moves.
+class Counted{
+public:
+    static int copies;
+    static int moves;
+    int value;
+
+    explicit Counted(int value) : value(value){
+    }
+
+    Counted(const Counted& c) : value(c.value){
+        copies++;
+    }
+
+    Counted(Counted&& c) : value(c.value){
+        moves++;
+    }
+};
+
+int Counted::copies = 0;
+int Counted::moves = 0;
+
+Counted make_counted(int value)
+{
+    return Counted(value);
+}
+
+int counted_value(Counted& c)
+{
+    return c.value;
+}
+
+int main() {
+  mrb_state* mrb = mrb_open();
+
+  {
+    mrubybind::MrubyBind b(mrb);
+    b.bind_class<Counted>("Counted");
+    b.bind("make_counted", make_counted);
+    b.bind("counted_value", counted_value);
+  }
+
+  int result_code = EXIT_SUCCESS;
+  mrb_load_string(mrb,
+                  "a = make_counted 1\n"
+                  "b = make_counted 2\n"
+                  "c = make_counted 3\n"
+                  "puts counted_value(a) + counted_value(b) + counted_value(c)\n"
+                  );
+  if (mrb->exc) {
+    mrb_p(mrb, mrb_obj_value(mrb->exc));
+    result_code = EXIT_FAILURE;
+  }
+  cout << "copies = " << Counted::copies << ", moves = " << Counted::moves << endl;
+
+  mrb_close(mrb);
+  return result_code;
+}
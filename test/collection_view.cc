@@ -0,0 +1,69 @@
+#include <mruby.h>
+#include <mruby/compile.h>
+#include "mrubybind.h"
+
+#include <iostream>
+using namespace std;
+
+int sum(mrubybind::ArrayView<int> a)
+{
+    int s = 0;
+    for(mrubybind::ArrayView<int>::iterator i = a.begin() ; i != a.end() ; ++i){
+        s += *i;
+    }
+    return s;
+}
+
+int main() {
+  mrb_state* mrb = mrb_open();
+
+  {
+    mrubybind::MrubyBind b(mrb);
+    b.bind("sum", sum);
+  }
+
+  int result_code = EXIT_SUCCESS;
+  mrb_load_string(mrb, "puts sum([1, 2, 3])\n");
+
+  int s = 0;
+  for(int i : mrubybind::load_string(mrb, "(1..100).to_a").array_view<int>()){
+    s += i;
+  }
+  cout << s << endl;
+
+  for(mrubybind::MrubyValueView v : mrubybind::load_string(mrb, "['a', :b, 3]").array_view<mrubybind::MrubyValueView>()){
+    mrb_load_string(mrb, "GC.start");
+    cout << v.to_s() << endl;
+  }
+
+  int total = 0;
+  mrubybind::MrubyRef h = mrubybind::load_string(mrb, "{'x' => 1, 'y' => 2}");
+  for(std::pair<std::string, int> e : h.hash_view<std::string, int>()){
+    total += (int)e.first.size() + e.second;
+  }
+  cout << h.hash_view<std::string, int>().size() << " " << total << endl;
+
+  // Shrinking the Array ends the loop early.
+  const char* sep = "";
+  for(int i : mrubybind::load_string(mrb, "$a = [1, 2, 3, 4]").array_view<int>()){
+    mrb_load_string(mrb, "$a.pop");
+    cout << sep << i;
+    sep = " ";
+  }
+  cout << endl;
+
+  try{
+    mrubybind::load_string(mrb, "[1, 'a']").array_view<int>();
+  }
+  catch(std::exception& e){
+    cout << e.what() << endl;
+  }
+  if (mrb->exc) {
+    mrb_p(mrb, mrb_obj_value(mrb->exc));
+    result_code = EXIT_FAILURE;
+  }
+  h = mrubybind::MrubyRef();
+
+  mrb_close(mrb);
+  return result_code;
+}
@@ -0,0 +1,163 @@
+#include <mruby.h>
+#include <mruby/compile.h>
+#include "mrubybind.h"
+
+#include <iostream>
+#include <thread>
+#include <vector>
+using namespace std;
+
+mrubybind::FuncPtr<int(int a0)> kept;
+mrubybind::MrubyRef kept_ref;
+
+void keep(mrubybind::MrubyRef r, mrubybind::FuncPtr<int(int a0)> f)
+{
+    kept = f;
+    kept_ref = r;
+}
+
+mrb_state* vm;
+
+int drain()
+{
+    return (int)mrubybind::run_pending(vm);
+}
+
+// Objects pinned in the table; freed slots are nil.
+int pinned(mrb_state* mrb, mrb_value table)
+{
+    int n = 0;
+    for(mrb_int i = 0 ; i < mrb_ary_len(mrb, table) ; i++){
+        if(!mrb_nil_p(mrb_ary_ref(mrb, table, i))){
+            n++;
+        }
+    }
+    return n;
+}
+
+int main() {
+  mrb_state* mrb = mrb_open();
+  vm = mrb;
+
+  mrb_value table;
+  {
+    mrubybind::MrubyBind b(mrb);
+    b.bind("keep", keep);
+    b.bind("drain", drain);
+    table = b.get_avoid_gc_table();
+  }
+
+  int result_code = EXIT_SUCCESS;
+  mrb_load_string(mrb,
+                  "keep('ref') { |a0| puts \"called #{a0}\"; a0 * 2 }\n"
+                  );
+  cout << "pinned " << pinned(mrb, table) << endl;
+
+  // Calls and releases from another thread wait for the VM thread.
+  std::vector<std::future<int> > results;
+  std::thread worker([&]{
+    for(int i = 1 ; i <= 3 ; i++){
+      results.push_back(kept.call_async(i));
+    }
+    kept.reset();
+    kept_ref = mrubybind::MrubyRef();
+  });
+  worker.join();
+  cout << "pinned " << pinned(mrb, table) << endl;
+
+  size_t n = mrubybind::run_pending(mrb);
+  cout << "ran " << n << endl;
+  cout << "pinned " << pinned(mrb, table) << endl;
+
+  int sum = 0;
+  for(size_t i = 0 ; i < results.size() ; i++){
+    sum += results[i].get();
+  }
+  cout << sum << endl;
+
+  // A block that raises puts the exception in its future, whether it runs
+  // inside the VM or from load_string(), and leaves the caller alone.
+  mrb_load_string(mrb,
+                  "keep('ref') { |a0| raise ArgumentError, \"bad #{a0}\" if a0 > 4; a0 * 3 }\n"
+                  );
+  std::future<int> good, bad;
+  std::thread poster([&]{
+    good = kept.call_async(4);
+    bad = kept.call_async(5);
+  });
+  poster.join();
+  mrb_load_string(mrb, "puts \"drained #{drain}\"\n");
+  cout << good.get() << endl;
+  try {
+    bad.get();
+  }
+  catch (const std::exception& e) {
+    cout << e.what() << endl;
+  }
+  std::thread poster2([&]{
+    bad = kept.call_async(6);
+  });
+  poster2.join();
+  cout << mrubybind::load_string(mrb, "40 + 2").to_i() << endl;
+  try {
+    bad.get();
+  }
+  catch (const std::exception& e) {
+    cout << e.what() << endl;
+  }
+  if (mrb->exc) {
+    mrb_p(mrb, mrb_obj_value(mrb->exc));
+    result_code = EXIT_FAILURE;
+  }
+
+  // An exception left by a script, or pending in the caller of
+  // run_pending(), isn't taken for the failure of a block.
+  mrubybind::load_string(mrb, "raise 'script'");
+  std::thread poster3([&]{
+    good = kept.call_async(3);
+    bad = kept.call_async(2);
+  });
+  poster3.join();
+  mrubybind::load_string(mrb, "nil");
+  cout << good.get() << endl;
+  cout << bad.get() << endl;
+  struct RObject* exc = (struct RObject*)mrb_ptr(mrb_exc_new_str(mrb, E_RUNTIME_ERROR, mrb_str_new_cstr(mrb, "caller")));
+  mrb->exc = exc;
+  std::thread poster4([&]{
+    good = kept.call_async(1);
+  });
+  poster4.join();
+  mrubybind::run_pending(mrb);
+  cout << good.get() << endl;
+  cout << (mrb->exc == exc ? "kept caller exception" : "lost caller exception") << endl;
+  mrb->exc = NULL;
+
+  // Calls still queued when the VM closes break their promises.
+  mrb_load_string(mrb,
+                  "keep('ref') { |a0| a0 }\n"
+                  );
+  std::future<int> pending;
+  std::thread late([&]{
+    pending = kept.call_async(1);
+    kept.reset();
+  });
+  late.join();
+  std::weak_ptr<mrubybind::MrubyBindStatus::Data> data = mrubybind::MrubyBindStatus::search(mrb);
+
+  mrb_close(mrb);
+  try {
+    pending.get();
+  }
+  catch (const std::future_error& e) {
+    cout << (e.code() == std::future_errc::broken_promise ? "broken promise" : e.what()) << endl;
+  }
+
+  // A reference released on another thread after the VM closed lets its
+  // bindings go.
+  std::thread release([&]{
+    kept_ref = mrubybind::MrubyRef();
+  });
+  release.join();
+  cout << (data.expired() ? "released" : "leaked") << endl;
+  return result_code;
+}
@@ -0,0 +1,60 @@
+#include <mruby.h>
+#include <mruby/compile.h>
+#include "mrubybind.h"
+
+#include <iostream>
+using namespace std;
+
+// Block used only during the call.
+int call_twice(mrubybind::FuncRef<int(int a0)> f)
+{
+    return f(1) + f(2);
+}
+
+std::string greet(std::string name, mrubybind::FuncRef<std::string(std::string a0)> f)
+{
+    return f("hello " + name);
+}
+
+// Block kept after the call.
+mrubybind::FuncPtr<void(int a0)> kept;
+
+void keep(mrubybind::FuncPtr<void(int a0)> f)
+{
+    kept = f;
+}
+
+void call_kept(int a0)
+{
+    kept.func()(a0);
+}
+
+int main() {
+  mrb_state* mrb = mrb_open();
+
+  {
+    mrubybind::MrubyBind b(mrb);
+    b.bind("call_twice", call_twice);
+    b.bind("greet", greet);
+    b.bind("keep", keep);
+    b.bind("call_kept", call_kept);
+  }
+
+  int result_code = EXIT_SUCCESS;
+  mrb_load_string(mrb,
+                  "puts call_twice { |a0| a0 * 10 }\n"
+                  "puts call_twice(proc { |a0| a0 + 1 })\n"
+                  "puts greet('mruby') { |s| s.upcase }\n"
+                  "keep { |a0| puts \"kept #{a0}\" }\n"
+                  "GC.start\n"
+                  "call_kept 7\n"
+                  );
+  if (mrb->exc) {
+    mrb_p(mrb, mrb_obj_value(mrb->exc));
+    result_code = EXIT_FAILURE;
+  }
+  kept.reset();
+
+  mrb_close(mrb);
+  return result_code;
+}
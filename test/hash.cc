@@ -0,0 +1,91 @@
+#include <mruby.h>
+#include <mruby/compile.h>
+#include "mrubybind.h"
+
+#include <iostream>
+using namespace std;
+
+std::string join(std::map<std::string, int> m)
+{
+    std::string s;
+    for(auto& kv : m){
+        s += kv.first + "=" + std::to_string(kv.second) + ";";
+    }
+    return s;
+}
+
+std::map<int, std::string> names()
+{
+    std::map<int, std::string> m;
+    m[1] = "one";
+    m[2] = "two";
+    return m;
+}
+
+int total(const std::unordered_map<std::string, int>& m)
+{
+    int s = 0;
+    for(auto& kv : m){
+        s += kv.second;
+    }
+    return s;
+}
+
+std::unordered_map<std::string, std::vector<int> > groups()
+{
+    std::unordered_map<std::string, std::vector<int> > m;
+    m["odd"] = {1, 3};
+    return m;
+}
+
+int lookup(mrubybind::HashView<std::string, int> h, std::string key)
+{
+    return h.has_key(key) ? h.get(key) : -1;
+}
+
+int view_total(mrubybind::HashView<std::string, int> h)
+{
+    int s = 0;
+    for(auto kv : h){
+        s += kv.second;
+    }
+    return s + (int)h.size() * 100;
+}
+
+int main() {
+  mrb_state* mrb = mrb_open();
+
+  {
+    mrubybind::MrubyBind b(mrb);
+    b.bind("join", join);
+    b.bind("names", names);
+    b.bind("total", total);
+    b.bind("groups", groups);
+    b.bind("lookup", lookup);
+    b.bind("view_total", view_total);
+  }
+
+  int result_code = EXIT_SUCCESS;
+  mrb_load_string(mrb,
+                  "puts join({'b' => 2, 'a' => 1})\n"
+                  "p names[2]\n"
+                  "puts total({'x' => 3, 'y' => 4})\n"
+                  "p groups\n"
+                  "h = {'x' => 3, 'y' => 4}\n"
+                  "puts lookup(h, 'y')\n"
+                  "puts lookup(h, 'z')\n"
+                  "puts view_total(h)\n"
+                  "begin\n"
+                  "  view_total({'x' => 'y'})\n"
+                  "rescue TypeError => e\n"
+                  "  puts e.message\n"
+                  "end\n"
+                  );
+  if (mrb->exc) {
+    mrb_p(mrb, mrb_obj_value(mrb->exc));
+    result_code = EXIT_FAILURE;
+  }
+
+  mrb_close(mrb);
+  return result_code;
+}
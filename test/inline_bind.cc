@@ -0,0 +1,71 @@
+#include <mruby.h>
+#include <mruby/compile.h>
+#include "mrubybind.h"
+
+#include <iostream>
+using namespace std;
+
+int square(int x) {
+  return x * x;
+}
+
+class Counter {
+public:
+  int count;
+  Counter() : count(0) {}
+  void add(int n) {
+    count += n;
+  }
+  int get() {
+    return count;
+  }
+};
+
+Counter* new_counter() {
+  return new Counter();
+}
+
+int counter_twice(Counter& c) {
+  return c.count * 2;
+}
+
+int main() {
+  mrb_state* mrb = mrb_open();
+
+  {
+    mrubybind::MrubyBind b(mrb);
+    b.bind<MRUBYBIND_FUNC(&square)>("square");
+    b.bind_class("Counter", new_counter);
+    b.bind_instance_method<MRUBYBIND_FUNC(&Counter::add)>("Counter", "add");
+    b.bind_instance_method<MRUBYBIND_FUNC(&Counter::get)>("Counter", "get");
+    b.bind_static_method<MRUBYBIND_FUNC(&square)>("Counter", "square");
+    b.bind_custom_method<MRUBYBIND_FUNC(&counter_twice)>("Counter", "twice");
+  }
+  if (mrb_gc_arena_save(mrb) != 0) {
+    fprintf(stderr, "Arena increased!\n");
+    return EXIT_FAILURE;
+  }
+
+  int result_code = EXIT_SUCCESS;
+  mrb_load_string(mrb,
+                  "puts square(1111)\n"
+                  "c = Counter.new\n"
+                  "c.add 3\n"
+                  "c.add 4\n"
+                  "puts c.get\n"
+                  "puts c.twice\n"
+                  "puts Counter.square(12)\n"
+                  "begin\n"
+                  "  square(1, 2)\n"
+                  "rescue ArgumentError => e\n"
+                  "  puts e.message\n"
+                  "end\n"
+                  );
+  if (mrb->exc) {
+    mrb_p(mrb, mrb_obj_value(mrb->exc));
+    result_code = EXIT_FAILURE;
+  }
+
+  mrb_close(mrb);
+  return result_code;
+}
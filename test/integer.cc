@@ -0,0 +1,85 @@
+#include <mruby.h>
+#include <mruby/compile.h>
+#include "mrubybind.h"
+
+#include <cstdint>
+#include <iostream>
+using namespace std;
+
+int64_t add_ms(int64_t t, int32_t ms)
+{
+    return t + ms;
+}
+
+uint8_t next_byte(uint8_t b)
+{
+    return b + 1;
+}
+
+int16_t negate16(int16_t i)
+{
+    return -i;
+}
+
+size_t offset(size_t base, unsigned int n)
+{
+    return base + n;
+}
+
+uint64_t huge()
+{
+    return UINT64_MAX;
+}
+
+uint64_t power60()
+{
+    return (uint64_t)1 << 60;
+}
+
+int identity(int i)
+{
+    return i;
+}
+
+int main() {
+  mrb_state* mrb = mrb_open();
+
+  {
+    mrubybind::MrubyBind b(mrb);
+    b.bind("add_ms", add_ms);
+    b.bind("next_byte", next_byte);
+    b.bind("negate", negate16);
+    b.bind("offset", offset);
+    b.bind("huge", huge);
+    b.bind("power60", power60);
+    b.bind("identity", identity);
+  }
+
+  int result_code = EXIT_SUCCESS;
+  mrb_load_string(mrb,
+                  "puts add_ms(1000, 5)\n"
+                  "puts next_byte(254)\n"
+                  "puts negate(-3)\n"
+                  "puts offset(4096, 4.0)\n"
+                  "puts power60 == 2.0 ** 60\n"
+                  "[\n"
+                  "  lambda { next_byte(256) },\n"
+                  "  lambda { offset(-1, 0) },\n"
+                  "  lambda { identity(1.5) },\n"
+                  "  lambda { huge },\n"
+                  "].each do |f|\n"
+                  "  begin\n"
+                  "    f.call\n"
+                  "  rescue => e\n"
+                  "    puts \"#{e.class}: #{e.message}\"\n"
+                  "  end\n"
+                  "end\n"
+                  );
+  if (mrb->exc) {
+    mrb_p(mrb, mrb_obj_value(mrb->exc));
+    result_code = EXIT_FAILURE;
+  }
+
+  mrb_close(mrb);
+  return result_code;
+}
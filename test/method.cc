@@ -0,0 +1,109 @@
+#include <mruby.h>
+#include <mruby/compile.h>
+#include "mrubybind.h"
+
+#include <iostream>
+using namespace std;
+
+int main() {
+  mrb_state* mrb = mrb_open();
+
+  {
+    mrubybind::MrubyBind b(mrb);
+  }
+
+  int result_code = EXIT_SUCCESS;
+  mrubybind::MrubyRef hooks = mrubybind::load_string(mrb,
+                  "class Hooks\n"
+                  "  def on_record(a, b)\n"
+                  "    a * b\n"
+                  "  end\n"
+                  "  def self.name_of(s)\n"
+                  "    \"hook #{s}\"\n"
+                  "  end\n"
+                  "  def fail(m)\n"
+                  "    raise m\n"
+                  "  end\n"
+                  "  def method_missing(name, *args)\n"
+                  "    \"missing #{name}\"\n"
+                  "  end\n"
+                  "end\n"
+                  "Hooks.new\n"
+                  );
+  {
+    mrubybind::MrubyMethod on_record(hooks, "on_record");
+    int sum = 0;
+    for(int i = 0 ; i < 1000 ; i++){
+      sum += on_record.call(i, 2).to_i();
+    }
+    cout << sum << endl;
+
+    // Redefined: the handle keeps the method it found until invalidate().
+    mrubybind::load_string(mrb,
+                    "class Hooks\n"
+                    "  def on_record(a, b)\n"
+                    "    a + b\n"
+                    "  end\n"
+                    "end\n"
+                    );
+    cout << on_record.call(3, 4).to_i() << endl;
+    on_record.invalidate();
+    cout << on_record.call(3, 4).to_i() << endl;
+
+    mrubybind::MrubyMethod name_of(mrubybind::load_string(mrb, "Hooks"), "name_of");
+    cout << name_of.call("x").to_s() << endl;
+
+    mrubybind::MrubyMethod missing(hooks, "on_close");
+    cout << missing.call().to_s() << endl;
+
+    // The GC doesn't free the method kept by the handle, nor its receiver.
+    mrb_load_string(mrb,
+                    "class Hooks\n"
+                    "  def on_record(a, b)\n"
+                    "    a - b\n"
+                    "  end\n"
+                    "end\n"
+                    );
+    mrb_full_gc(mrb);
+    cout << on_record.call(3, 4).to_i() << endl;
+    on_record.invalidate();
+    cout << on_record.call(3, 4).to_i() << endl;
+
+    // A singleton method changes the receiver's class, so it is found
+    // without invalidate().
+    mrubybind::MrubyMethod single(mrubybind::load_string(mrb,
+                    "$single = Hooks.new\n"
+                    ), "on_record");
+    cout << single.call(3, 4).to_i() << endl;
+    mrubybind::load_string(mrb,
+                    "def $single.on_record(a, b)\n"
+                    "  a * 10 + b\n"
+                    "end\n"
+                    );
+    cout << single.call(3, 4).to_i() << endl;
+
+    // A method that raises leaves the exception in mrb->exc, whether it is
+    // written in Ruby or C.
+    mrubybind::MrubyMethod fail(hooks, "fail");
+    fail.call("failed");
+    if (mrb->exc) {
+      cout << mrubybind::MrubyRef(mrb, mrb_obj_value(mrb->exc)).call("message").to_s() << endl;
+      mrb->exc = NULL;
+    }
+    mrubybind::MrubyMethod raise(hooks, "raise");
+    raise.call("boom");
+    if (mrb->exc) {
+      cout << mrubybind::MrubyRef(mrb, mrb_obj_value(mrb->exc)).call("message").to_s() << endl;
+      mrb->exc = NULL;
+    }
+    cout << on_record.call(3, 4).to_i() << endl;
+  }
+  if (mrb->exc) {
+    mrb_p(mrb, mrb_obj_value(mrb->exc));
+    result_code = EXIT_FAILURE;
+  }
+  hooks = mrubybind::MrubyRef();
+
+  mrb_close(mrb);
+  return result_code;
+}
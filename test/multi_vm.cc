@@ -0,0 +1,89 @@
+#include <mruby.h>
+#include <mruby/compile.h>
+#include "mrubybind.h"
+
+#include <iostream>
+using namespace std;
+
+class Point{
+public:
+    int x;
+    Point() : x(0){
+    }
+};
+
+std::shared_ptr<Point> new_point(int x)
+{
+    std::shared_ptr<Point> p = std::make_shared<Point>();
+    p->x = x;
+    return p;
+}
+
+int point_x(std::shared_ptr<Point> p)
+{
+    return p->x;
+}
+
+// Bound with a constructor function.
+class Counter{
+public:
+    int n;
+    explicit Counter(int n) : n(n){
+    }
+};
+
+Counter* new_counter(int n)
+{
+    return new Counter(n);
+}
+
+Counter doubled(Counter& c)
+{
+    return Counter(c.n * 2);
+}
+
+int counter_value(Counter& c)
+{
+    return c.n;
+}
+
+mrb_state* open_vm(const char* module_name, const char* class_name)
+{
+    mrb_state* mrb = mrb_open();
+    mrubybind::MrubyBind b(mrb);
+    b.bind_class<std::shared_ptr<Point> >(module_name, class_name);
+    b.bind("new_point", new_point);
+    b.bind("point_x", point_x);
+    b.bind_class("Counter", new_counter);
+    b.bind("doubled", doubled);
+    b.bind("counter_value", counter_value);
+    return mrb;
+}
+
+int main() {
+  // The same C++ type is bound under different names in each VM.
+  mrb_state* mrb1 = open_vm(NULL, "Point");
+  mrb_state* mrb2 = open_vm("Geo", "Vec");
+
+  int result_code = EXIT_SUCCESS;
+  const char* code =
+      "p = new_point 3\n"
+      "puts \"#{p.class} #{point_x p}\"\n"
+      "c = doubled(Counter.new(2))\n"
+      "puts \"#{c.class} #{counter_value c}\"\n";
+  mrb_load_string(mrb1, code);
+  mrb_load_string(mrb2, code);
+  mrb_load_string(mrb2, "puts Object.const_defined?(:Point)");
+  if (mrb1->exc) {
+    mrb_p(mrb1, mrb_obj_value(mrb1->exc));
+    result_code = EXIT_FAILURE;
+  }
+  if (mrb2->exc) {
+    mrb_p(mrb2, mrb_obj_value(mrb2->exc));
+    result_code = EXIT_FAILURE;
+  }
+
+  mrb_close(mrb1);
+  mrb_close(mrb2);
+  return result_code;
+}
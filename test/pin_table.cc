@@ -0,0 +1,65 @@
+#include <mruby.h>
+#include <mruby/compile.h>
+#include "mrubybind.h"
+
+#include <iostream>
+#include <vector>
+using namespace std;
+
+std::vector<mrubybind::MrubyRef> refs;
+
+void keep(mrubybind::MrubyRef r)
+{
+    refs.push_back(r);
+}
+
+void release(int n)
+{
+    refs.erase(refs.begin(), refs.begin() + n);
+}
+
+int first()
+{
+    return refs.front().to_i();
+}
+
+int main() {
+  mrb_state* mrb = mrb_open();
+
+  mrb_value table;
+  {
+    mrubybind::MrubyBind b(mrb);
+    b.bind("keep", keep);
+    b.bind("release", release);
+    b.bind("first", first);
+    table = b.get_avoid_gc_table();
+  }
+
+  int result_code = EXIT_SUCCESS;
+  mrb_load_string(mrb,
+                  "1000.times do |i|\n"
+                  "  keep \"#{i}\"\n"
+                  "end\n"
+                  );
+  cout << "pinned " << mrb_ary_len(mrb, table) << endl;
+  mrb_load_string(mrb, "release 900\nGC.start");
+  cout << "pinned " << mrb_ary_len(mrb, table) << endl;
+  mrb_load_string(mrb, "puts first");
+  refs.clear();
+  cout << "pinned " << mrb_ary_len(mrb, table) << endl;
+  // Pinning and unpinning in a loop reuses a free slot.
+  mrb_load_string(mrb,
+                  "100.times do |i|\n"
+                  "  keep \"#{i}\"\n"
+                  "  release 1\n"
+                  "end\n"
+                  );
+  cout << "pinned " << mrb_ary_len(mrb, table) << endl;
+  if (mrb->exc) {
+    mrb_p(mrb, mrb_obj_value(mrb->exc));
+    result_code = EXIT_FAILURE;
+  }
+
+  mrb_close(mrb);
+  return result_code;
+}
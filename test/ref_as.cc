@@ -0,0 +1,59 @@
+#include <mruby.h>
+#include <mruby/compile.h>
+#include "mrubybind.h"
+
+#include <iostream>
+using namespace std;
+
+int main() {
+  mrb_state* mrb = mrb_open();
+
+  {
+    mrubybind::MrubyBind b(mrb);
+  }
+
+  int result_code = EXIT_SUCCESS;
+  cout << mrubybind::load_string(mrb, "40 + 2").as<int>() << endl;
+  cout << mrubybind::load_string(mrb, "2 ** 40").as<long long>() << endl;
+  cout << mrubybind::load_string(mrb, "1.5").as<double>() << endl;
+  cout << mrubybind::load_string(mrb, ":sym").as<std::string>() << endl;
+  cout << mrubybind::load_string(mrb, "'12'").as<int>() << endl;
+#ifdef MRB_INT64
+  // to_i() truncates a Fixnum out of int range.
+  cout << mrubybind::load_string(mrb, "2 ** 32 + 5").to_i() << endl;
+#else
+  // Every Fixnum fits in int.
+  cout << mrubybind::load_string(mrb, "5").to_i() << endl;
+#endif
+
+  std::vector<int> v = mrubybind::load_string(mrb, "[1, 2, 3]").as<std::vector<int> >();
+  cout << v[0] + v[1] + v[2] << endl;
+
+  int i = 0;
+  cout << (mrubybind::load_string(mrb, "Object.new").try_as(i) ? "true" : "false") << endl;
+  try{
+    mrubybind::load_string(mrb, "Object.new").as<int>();
+  }
+  catch(std::exception& e){
+    cout << e.what() << endl;
+  }
+  try{
+    mrubybind::load_string(mrb, "100000").as<short>();
+  }
+  catch(std::exception& e){
+    cout << e.what() << endl;
+  }
+  try{
+    mrubybind::load_string(mrb, "'300'").as<unsigned char>();
+  }
+  catch(std::exception& e){
+    cout << e.what() << endl;
+  }
+  if (mrb->exc) {
+    mrb_p(mrb, mrb_obj_value(mrb->exc));
+    result_code = EXIT_FAILURE;
+  }
+
+  mrb_close(mrb);
+  return result_code;
+}
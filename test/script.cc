@@ -0,0 +1,49 @@
+#include <mruby.h>
+#include <mruby/compile.h>
+#include "mrubybind.h"
+
+#include <iostream>
+using namespace std;
+
+int main() {
+  mrb_state* mrb = mrb_open();
+
+  {
+    mrubybind::MrubyBind b(mrb);
+  }
+
+  int result_code = EXIT_SUCCESS;
+  {
+    mrubybind::MrubyScript on_event(mrb,
+                    "$events = ($events || 0) + 1\n"
+                    "$events * 10\n",
+                    "on_event.rb");
+    for(int i = 0 ; i < 3 ; i++){
+      cout << on_event.run().to_i() << endl;
+    }
+
+    mrubybind::MrubyScript where(mrb,
+                    "x = 1\n"
+                    "\"#{__FILE__}:#{__LINE__}\"\n",
+                    "where.rb");
+    cout << where.run().to_s() << endl;
+
+    mrubybind::MrubyScript bad(mrb, "1 +", "bad.rb");
+    cout << (bad.empty() && mrb->exc ? "syntax error" : "compiled") << endl;
+
+    mrubybind::MrubyScript raises(mrb, "raise 'oops'");
+    mrubybind::MrubyRef r = raises.run();
+    if (mrb->exc) {
+      cout << mrubybind::MrubyRef(mrb, mrb_obj_value(mrb->exc)).call("message").to_s() << endl;
+      mrb->exc = NULL;
+    }
+    cout << r.test() << endl;
+  }
+  if (mrb->exc) {
+    mrb_p(mrb, mrb_obj_value(mrb->exc));
+    result_code = EXIT_FAILURE;
+  }
+
+  mrb_close(mrb);
+  return result_code;
+}
@@ -0,0 +1,105 @@
+#include <mruby.h>
+#include <mruby/compile.h>
+#include "mrubybind.h"
+
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <iostream>
+#include <vector>
+using namespace std;
+
+static const char* script = "$n = ($n || 0) + 1\n";
+
+static vector<string> cache_files(const string& dir)
+{
+  vector<string> files;
+  if (DIR* d = opendir(dir.c_str())) {
+    while (dirent* e = readdir(d)) {
+      string name = e->d_name;
+      if (name != "." && name != "..") {
+        files.push_back(dir + "/" + name);
+      }
+    }
+    closedir(d);
+  }
+  return files;
+}
+
+// Runs the script in a new VM and prints how many scripts it read from dir.
+static int run_in_new_vm(const string& dir)
+{
+  mrb_state* mrb = mrb_open();
+  {
+    mrubybind::MrubyBind b(mrb);
+  }
+  mrubybind::set_script_cache_dir(mrb, dir);
+  mrubybind::MrubyRef n = mrubybind::load_string(mrb, script);
+  cout << "loaded " << mrubybind::get_script_cache_stats(mrb).loaded
+       << ", n = " << n.to_i() << endl;
+  int result_code = EXIT_SUCCESS;
+  if (mrb->exc) {
+    mrb_p(mrb, mrb_obj_value(mrb->exc));
+    result_code = EXIT_FAILURE;
+  }
+  n = mrubybind::MrubyRef();
+  mrb_close(mrb);
+  return result_code;
+}
+
+int main() {
+  char dir_name[] = "/tmp/script_cache.XXXXXX";
+  if (!mkdtemp(dir_name)) {
+    return EXIT_FAILURE;
+  }
+  string dir = dir_name;
+
+  mrb_state* mrb = mrb_open();
+
+  {
+    mrubybind::MrubyBind b(mrb);
+  }
+
+  int result_code = EXIT_SUCCESS;
+  mrubybind::set_script_cache_dir(mrb, dir);
+  for(int i = 0 ; i < 3 ; i++){
+    mrubybind::load_string(mrb, script);
+  }
+  // Syntax errors are not kept.
+  mrubybind::load_string(mrb, "1 +");
+  if (!mrb->exc) {
+    result_code = EXIT_FAILURE;
+  }
+  mrubybind::ScriptCacheStats stats = mrubybind::get_script_cache_stats(mrb);
+  cout << "hits " << stats.hits << ", misses " << stats.misses
+       << ", size " << stats.size << endl;
+  cout << mrubybind::load_string(mrb, "$n").to_i() << endl;
+  mrubybind::clear_script_cache(mrb);
+  cout << "size " << mrubybind::get_script_cache_stats(mrb).size << endl;
+  mrb_close(mrb);
+
+  // Another VM reads the script compiled by the first one.
+  if (run_in_new_vm(dir) != EXIT_SUCCESS) {
+    result_code = EXIT_FAILURE;
+  }
+
+  // A file whose text doesn't match isn't used.
+  vector<string> files = cache_files(dir);
+  for (size_t i = 0 ; i < files.size() ; i++) {
+    if (FILE* fp = fopen(files[i].c_str(), "ab")) {
+      fputs("# changed\n", fp);
+      fclose(fp);
+    }
+  }
+  if (run_in_new_vm(dir) != EXIT_SUCCESS) {
+    result_code = EXIT_FAILURE;
+  }
+
+  files = cache_files(dir);
+  for (size_t i = 0 ; i < files.size() ; i++) {
+    remove(files[i].c_str());
+  }
+  rmdir(dir.c_str());
+  return result_code;
+}
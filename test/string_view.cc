@@ -0,0 +1,47 @@
+#include <mruby.h>
+#include <mruby/compile.h>
+#include "mrubybind.h"
+
+#include <iostream>
+#include <string_view>
+using namespace std;
+
+// Built with -std=c++17, see the Makefile.
+int line_length(std::string_view line)
+{
+    return (int)line.size();
+}
+
+std::string_view first_field(std::string_view line)
+{
+    return line.substr(0, line.find(','));
+}
+
+int main() {
+  mrb_state* mrb = mrb_open();
+
+  {
+    mrubybind::MrubyBind b(mrb);
+    b.bind("line_length", line_length);
+    b.bind("first_field", first_field);
+  }
+
+  int result_code = EXIT_SUCCESS;
+  mrb_load_string(mrb,
+                  "line = \"abc,de,\\0,fgh\"\n"
+                  "puts line_length(line)\n"
+                  "puts first_field(line)\n"
+                  "begin\n"
+                  "  line_length(12)\n"
+                  "rescue TypeError => e\n"
+                  "  puts e.message\n"
+                  "end\n"
+                  );
+  if (mrb->exc) {
+    mrb_p(mrb, mrb_obj_value(mrb->exc));
+    result_code = EXIT_FAILURE;
+  }
+
+  mrb_close(mrb);
+  return result_code;
+}
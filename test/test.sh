@@ -86,6 +86,135 @@ called!
 start avoid_gc 2
 called!
 block called!'
+run inline_bind "1234321
+7
+14
+144
+'square': wrong number of arguments (2 for 1)"
+run class_return '6
+copies = 0, moves = 3'
+run byte_span '4
+abc
+12'
+run vector "10
+100000
+[0.5, 1.0, 1.5]
+[\"a\", \"bc\", \"def\"]
+[[1, 4], [2, 5], [3, 6]]
+can't convert Array into Array of Fixnum, argument 1([1, \"x\"])"
+run hash "a=1;b=2;
+\"two\"
+7
+{\"odd\"=>[1, 3]}
+4
+-1
+207
+can't convert Hash into Hash of String => Fixnum, argument 1({\"x\"=>\"y\"})"
+run integer "1005
+255
+3
+4100
+true
+TypeError: can't convert Fixnum into uint8, argument 1(256)
+TypeError: can't convert Fixnum into uint64, argument 1(-1)
+TypeError: can't convert Float into Fixnum, argument 1(1.5)
+RangeError: integer 18446744073709551615 too big to convert into Fixnum"
+run pin_table 'pinned 1000
+pinned 124
+900
+pinned 60
+pinned 60'
+run multi_vm 'Point 3
+Counter 4
+Geo::Vec 3
+Counter 4
+false'
+run func_ref '30
+5
+HELLO MRUBY
+kept 7'
+run call_each '[1, 4, 9]
+14
+x=1
+y=2
+a
+b'
+run dispatch 'pinned 2
+pinned 2
+called 1
+called 2
+called 3
+ran 4
+pinned 0
+12
+drained 2
+12
+ArgumentError: bad 5
+42
+ArgumentError: bad 6
+9
+6
+3
+kept caller exception
+broken promise
+released'
+run method '999000
+12
+7
+hook x
+missing on_close
+7
+-1
+-1
+34
+failed
+boom
+-1'
+run value_view '3
+kept abc
+living 0'
+run ref_as "42
+1099511627776
+1.5
+sym
+12
+5
+6
+false
+can't convert Object into Fixnum
+can't convert Fixnum into int16
+can't convert String into uint8"
+run collection_view "6
+5050
+a
+b
+3
+2 5
+1 2
+can't convert Array into Array of Fixnum"
+run script_cache 'hits 2, misses 2, size 1
+3
+size 0
+loaded 1, n = 1
+loaded 0, n = 1'
+run script '10
+20
+30
+where.rb:2
+syntax error
+oops
+0'
+run vm_thread 'pinned 1
+ready 1
+15
+pinned 0'
+run class_convert "TA -> a = 1
+TB -> b = 2
+TA -> b = 2
+TA -> b = 2"
+run string_view "12
+abc
+can't convert Fixnum into String, argument 1(12)"
 
 
 # Failure cases
@@ -0,0 +1,47 @@
+#include <mruby.h>
+#include <mruby/compile.h>
+#include "mrubybind.h"
+
+#include <iostream>
+using namespace std;
+
+mrubybind::MrubyRef kept;
+
+int length_of(mrubybind::MrubyValueView v)
+{
+    return v.call("size").to_i();
+}
+
+void keep(mrubybind::MrubyValueView v)
+{
+    kept = v;
+}
+
+int main() {
+  mrb_state* mrb = mrb_open();
+
+  {
+    mrubybind::MrubyBind b(mrb);
+    b.bind("length_of", length_of);
+    b.bind("keep", keep);
+  }
+
+  int result_code = EXIT_SUCCESS;
+  mrb_load_string(mrb,
+                  "puts length_of('abc')\n"
+                  "keep 'a' + 'bc'\n"
+                  "GC.start\n"
+                  );
+  {
+    mrubybind::MrubyRef copy = kept;
+    cout << "kept " << copy.to_s() << endl;
+  }
+  if (mrb->exc) {
+    mrb_p(mrb, mrb_obj_value(mrb->exc));
+    result_code = EXIT_FAILURE;
+  }
+
+  mrb_close(mrb);
+  cout << "living " << kept.is_living() << endl;
+  return result_code;
+}
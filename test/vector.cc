@@ -0,0 +1,92 @@
+#include <mruby.h>
+#include <mruby/compile.h>
+#include "mrubybind.h"
+
+#include <iostream>
+using namespace std;
+
+int sum(const std::vector<int>& v)
+{
+    int s = 0;
+    for(size_t i = 0 ; i < v.size() ; i++){
+        s += v[i];
+    }
+    return s;
+}
+
+std::vector<int> range(int n)
+{
+    std::vector<int> v;
+    for(int i = 0 ; i < n ; i++){
+        v.push_back(i);
+    }
+    return v;
+}
+
+std::vector<double> halves(std::vector<int> v)
+{
+    std::vector<double> r;
+    for(size_t i = 0 ; i < v.size() ; i++){
+        r.push_back(v[i] / 2.0);
+    }
+    return r;
+}
+
+std::vector<std::string> split(const std::string& s)
+{
+    std::vector<std::string> r(1);
+    for(size_t i = 0 ; i < s.size() ; i++){
+        if(s[i] == ' '){
+            r.push_back("");
+        }
+        else{
+            r.back() += s[i];
+        }
+    }
+    return r;
+}
+
+std::vector<std::vector<int> > transpose(std::vector<std::vector<int> > m)
+{
+    std::vector<std::vector<int> > t(m.empty() ? 0 : m[0].size(), std::vector<int>(m.size()));
+    for(size_t i = 0 ; i < m.size() ; i++){
+        for(size_t j = 0 ; j < m[i].size() ; j++){
+            t[j][i] = m[i][j];
+        }
+    }
+    return t;
+}
+
+int main() {
+  mrb_state* mrb = mrb_open();
+
+  {
+    mrubybind::MrubyBind b(mrb);
+    b.bind("sum", sum);
+    b.bind("range", range);
+    b.bind("halves", halves);
+    b.bind("split", split);
+    b.bind("transpose", transpose);
+  }
+
+  int result_code = EXIT_SUCCESS;
+  mrb_load_string(mrb,
+                  "puts sum([1, 2, 3, 4])\n"
+                  "puts range(100000).size\n"
+                  "p halves([1, 2, 3])\n"
+                  "p split('a bc def')\n"
+                  "p transpose([[1, 2, 3], [4, 5, 6]])\n"
+                  "begin\n"
+                  "  sum([1, 'x'])\n"
+                  "rescue TypeError => e\n"
+                  "  puts e.message\n"
+                  "end\n"
+                  );
+  if (mrb->exc) {
+    mrb_p(mrb, mrb_obj_value(mrb->exc));
+    result_code = EXIT_FAILURE;
+  }
+
+  mrb_close(mrb);
+  return result_code;
+}
@@ -0,0 +1,62 @@
+#include <mruby.h>
+#include <mruby/compile.h>
+#include "mrubybind.h"
+
+#include <iostream>
+#include <thread>
+using namespace std;
+
+mrubybind::FuncPtr<int(int a0)> kept;
+
+void keep(mrubybind::FuncPtr<int(int a0)> f)
+{
+    kept = f;
+}
+
+// Objects pinned in the table; freed slots are nil.
+int pinned(mrb_state* mrb, mrb_value table)
+{
+    int n = 0;
+    for(mrb_int i = 0 ; i < mrb_ary_len(mrb, table) ; i++){
+        if(!mrb_nil_p(mrb_ary_ref(mrb, table, i))){
+            n++;
+        }
+    }
+    return n;
+}
+
+int main() {
+  mrb_state* mrb = mrb_open();
+
+  mrb_value table;
+  {
+    mrubybind::MrubyBind b(mrb);
+    b.bind("keep", keep);
+    table = b.get_avoid_gc_table();
+  }
+
+  int result_code = EXIT_SUCCESS;
+
+  // Set up here, run on a worker which is given the VM.
+  std::thread worker([&]{
+    mrubybind::set_vm_thread(mrb);
+    mrb_load_string(mrb,
+                    "keep { |a0| a0 * 3 }\n"
+                    );
+    cout << "pinned " << pinned(mrb, table) << endl;
+    std::future<int> r = kept.call_async(5);
+    cout << "ready " << (r.wait_for(std::chrono::seconds(0)) == std::future_status::ready) << endl;
+    cout << r.get() << endl;
+    kept.reset();
+    cout << "pinned " << pinned(mrb, table) << endl;
+    if (mrb->exc) {
+      mrb_p(mrb, mrb_obj_value(mrb->exc));
+      result_code = EXIT_FAILURE;
+    }
+  });
+  worker.join();
+  mrubybind::set_vm_thread(mrb);
+
+  mrb_close(mrb);
+  return result_code;
+}